@@ -19,9 +19,22 @@ namespace UnrealBuildTool.Rules
                     "CoreUObject",
                     "Engine",
                     "DeveloperSettings",
-                    "GameFeatures"
+                    "GameFeatures",
+                    "StructUtils"
                 }
             );
+
+            PrivateDependencyModuleNames.AddRange(
+                new string[] {
+                    "NetCore",
+                    "Projects"
+                }
+            );
+
+            if (Target.bBuildEditor)
+            {
+                PrivateDependencyModuleNames.Add("UnrealEd");
+            }
         }
     }
 }
@@ -0,0 +1,221 @@
+#include "APArchetypeSnapshot.h"
+
+#include <Components/ActorComponent.h>
+#include <Engine/BlueprintGeneratedClass.h>
+#include <Interfaces/IPluginManager.h>
+#include <Interfaces/IProjectManager.h>
+#include <Net/Core/PushModel/PushModel.h>
+#include <ProjectDescriptor.h>
+#include <UObject/UnrealType.h>
+
+void FAPArchetypeSnapshot::Initialize( const UClass * object_class )
+{
+    Reset();
+
+    if ( object_class == nullptr )
+    {
+        return;
+    }
+
+    const auto * archetype = object_class->GetDefaultObject();
+    ObjectClass = object_class;
+    Archetype = archetype;
+
+    for ( TFieldIterator< FProperty > iterator( object_class ); iterator; ++iterator )
+    {
+        const auto * property = *iterator;
+
+        if ( !CanRestoreProperty( object_class, property ) )
+        {
+            continue;
+        }
+
+        // The replicated properties must be marked dirty when they are restored, so they can't be copied in a raw span
+        if ( property->HasAnyPropertyFlags( CPF_Net ) )
+        {
+            ReplicatedProperties.Add( property );
+            continue;
+        }
+
+        const auto * bool_property = CastField< FBoolProperty >( property );
+        const auto is_bitfield = bool_property != nullptr && !bool_property->IsNativeBool();
+
+        if ( property->HasAnyPropertyFlags( CPF_IsPlainOldData ) && !is_bitfield )
+        {
+            PlainOldDataSpans.Add( { property->GetOffset_ForInternal(), property->GetSize(), 0 } );
+        }
+        else
+        {
+            ComplexProperties.Add( property );
+        }
+    }
+
+    // TFieldIterator goes from the most derived class to its parents, so the spans must be sorted before they can be merged
+    PlainOldDataSpans.Sort( []( const FPlainOldDataSpan & left, const FPlainOldDataSpan & right ) {
+        return left.Offset < right.Offset;
+    } );
+
+    TArray< FPlainOldDataSpan > merged_spans;
+    merged_spans.Reserve( PlainOldDataSpans.Num() );
+
+    for ( const auto & span : PlainOldDataSpans )
+    {
+        if ( merged_spans.Num() > 0 && merged_spans.Last().Offset + merged_spans.Last().Size == span.Offset )
+        {
+            merged_spans.Last().Size += span.Size;
+        }
+        else
+        {
+            merged_spans.Add( span );
+        }
+    }
+
+    const auto * archetype_memory = reinterpret_cast< const uint8 * >( archetype );
+
+    for ( auto & span : merged_spans )
+    {
+        span.ValueOffset = PlainOldDataValues.Num();
+        PlainOldDataValues.Append( archetype_memory + span.Offset, span.Size );
+    }
+
+    PlainOldDataSpans = MoveTemp( merged_spans );
+}
+
+void FAPArchetypeSnapshot::Reset()
+{
+    ObjectClass.Reset();
+    Archetype.Reset();
+    PlainOldDataSpans.Reset();
+    PlainOldDataValues.Reset();
+    ComplexProperties.Reset();
+    ReplicatedProperties.Reset();
+}
+
+int FAPArchetypeSnapshot::RestoreArchetypeValues( UObject * object ) const
+{
+    const auto * archetype = Archetype.Get();
+
+    if ( object == nullptr || archetype == nullptr || object->GetClass() != ObjectClass.Get() )
+    {
+        return 0;
+    }
+
+    auto restored_count = 0;
+    auto * object_memory = reinterpret_cast< uint8 * >( object );
+    const auto * archetype_values = PlainOldDataValues.GetData();
+
+    for ( const auto & span : PlainOldDataSpans )
+    {
+        auto * value = object_memory + span.Offset;
+        const auto * archetype_value = archetype_values + span.ValueOffset;
+
+        if ( FMemory::Memcmp( value, archetype_value, span.Size ) != 0 )
+        {
+            FMemory::Memcpy( value, archetype_value, span.Size );
+            restored_count++;
+        }
+    }
+
+    for ( const auto * property : ComplexProperties )
+    {
+        if ( !property->Identical_InContainer( object, archetype ) )
+        {
+            property->CopyCompleteValue_InContainer( object, archetype );
+            restored_count++;
+        }
+    }
+
+    for ( const auto * property : ReplicatedProperties )
+    {
+        if ( !property->Identical_InContainer( object, archetype ) )
+        {
+            property->CopyCompleteValue_InContainer( object, archetype );
+            MARK_PROPERTY_DIRTY( object, property );
+            restored_count++;
+        }
+    }
+
+    return restored_count;
+}
+
+bool FAPArchetypeSnapshot::CanRestoreProperty( const UClass * object_class, const FProperty * property )
+{
+    // Only the properties declared by the game classes are restored. The state of the native classes of the engine and of its plugins
+    // (AActor, APawn, the components...) is managed by the engine itself
+    const auto * owner_class = property->GetOwnerClass();
+
+    if ( owner_class == nullptr || owner_class->HasAnyClassFlags( CLASS_Native ) && !GetGameScriptPackageNames().Contains( owner_class->GetOutermost()->GetFName() ) )
+    {
+        return false;
+    }
+
+    if ( property->HasAnyPropertyFlags( CPF_Deprecated | CPF_InstancedReference | CPF_ContainsInstancedReference ) )
+    {
+        return false;
+    }
+
+    // Delegates are bound at runtime and would be cleared by the archetype values
+    if ( property->IsA< FDelegateProperty >() || property->IsA< FMulticastDelegateProperty >() )
+    {
+        return false;
+    }
+
+    // Components are created per instance, the archetype only holds null pointers or pointers to its own templates
+    if ( const auto * object_property = CastField< FObjectPropertyBase >( property ) )
+    {
+        if ( object_property->PropertyClass != nullptr && object_property->PropertyClass->IsChildOf( UActorComponent::StaticClass() ) )
+        {
+            return false;
+        }
+    }
+
+#if USE_UBER_GRAPH_PERSISTENT_FRAME
+    if ( const auto * blueprint_class = Cast< UBlueprintGeneratedClass >( object_class ) )
+    {
+        for ( const auto * current_class = blueprint_class; current_class != nullptr; current_class = Cast< UBlueprintGeneratedClass >( current_class->GetSuperClass() ) )
+        {
+            if ( property == current_class->UberGraphFramePointerProperty )
+            {
+                return false;
+            }
+        }
+    }
+#endif
+
+    return true;
+}
+
+const TSet< FName > & FAPArchetypeSnapshot::GetGameScriptPackageNames()
+{
+    static TSet< FName > GGameScriptPackageNames;
+    static auto GIsInitialized = false;
+
+    if ( GIsInitialized )
+    {
+        return GGameScriptPackageNames;
+    }
+
+    GIsInitialized = true;
+
+    const auto add_modules = []( const TArray< FModuleDescriptor > & modules ) {
+        for ( const auto & module : modules )
+        {
+            GGameScriptPackageNames.Add( *FString::Printf( TEXT( "/Script/%s" ), *module.Name.ToString() ) );
+        }
+    };
+
+    if ( const auto * project_descriptor = IProjectManager::Get().GetCurrentProject() )
+    {
+        add_modules( project_descriptor->Modules );
+    }
+
+    for ( const auto & plugin : IPluginManager::Get().GetEnabledPlugins() )
+    {
+        if ( plugin->GetLoadedFrom() == EPluginLoadedFrom::Project )
+        {
+            add_modules( plugin->GetDescriptor().Modules );
+        }
+    }
+
+    return GGameScriptPackageNames;
+}
@@ -0,0 +1,204 @@
+#include "APAsyncAction_GetActorFromPool.h"
+
+#include "ActorPoolSubSystem.h"
+
+#include <Engine/AssetManager.h>
+#include <Engine/Engine.h>
+#include <Engine/StreamableManager.h>
+#include <Engine/World.h>
+#include <HAL/IConsoleManager.h>
+#include <TimerManager.h>
+
+static TAutoConsoleVariable< int32 > GActorPoolAsyncGrowthBudgetPerFrame(
+    TEXT( "ActorPool.AsyncGrowthBudgetPerFrame" ),
+    1,
+    TEXT( "Maximum number of instances the async acquisitions can add to the empty pools in a single frame. The other acquisitions wait for the next frames." ),
+    ECVF_Default );
+
+UAPAsyncAction_GetActorFromPool * UAPAsyncAction_GetActorFromPool::GetActorFromPoolAsync( UObject * world_context_object, TSoftClassPtr< AActor > actor_class, FTransform transform, float timeout )
+{
+    auto * action = NewObject< UAPAsyncAction_GetActorFromPool >();
+    action->World = GEngine->GetWorldFromContextObject( world_context_object, EGetWorldErrorMode::LogAndReturnNull );
+    action->ActorClass = actor_class;
+    action->Transform = transform;
+    action->CallerTag = world_context_object != nullptr ? world_context_object->GetClass()->GetFName() : NAME_None;
+    action->Timeout = timeout;
+    action->bIsFinished = false;
+    action->RegisterWithGameInstance( world_context_object );
+
+    return action;
+}
+
+void UAPAsyncAction_GetActorFromPool::Activate()
+{
+    if ( !World.IsValid() || ActorClass.IsNull() )
+    {
+        Finish( nullptr );
+        return;
+    }
+
+    // The timeout is in game time, like the retries of the acquisition which happen on the ticks of the world
+    World->GetTimerManager().SetTimer( TimeoutTimerHandle, FTimerDelegate::CreateUObject( this, &ThisClass::OnTimeout ), FMath::Max( Timeout, 0.001f ), false );
+
+    if ( ActorClass.Get() != nullptr )
+    {
+        OnClassLoaded();
+        return;
+    }
+
+    StreamableHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad( ActorClass.ToSoftObjectPath(), FStreamableDelegate::CreateUObject( this, &ThisClass::OnClassLoaded ) );
+}
+
+void UAPAsyncAction_GetActorFromPool::OnClassLoaded()
+{
+    StreamableHandle.Reset();
+
+    auto * world = World.Get();
+
+    if ( world == nullptr || ActorClass.Get() == nullptr )
+    {
+        Finish( nullptr );
+        return;
+    }
+
+    if ( auto * actor_pool_system = world->GetSubsystem< UActorPoolSubSystem >() )
+    {
+        actor_pool_system->OnActorPoolReady_RegisterAndCall( FAPOnActorPoolReadyEvent::CreateUObject( this, &ThisClass::OnActorPoolReady ) );
+    }
+    else
+    {
+        Finish( nullptr );
+    }
+}
+
+void UAPAsyncAction_GetActorFromPool::OnActorPoolReady( AActorPoolActor * /*actor_pool_actor*/ )
+{
+    TryAcquireActor();
+}
+
+void UAPAsyncAction_GetActorFromPool::TryAcquireActor()
+{
+    if ( bIsFinished )
+    {
+        return;
+    }
+
+    auto * world = World.Get();
+
+    if ( world == nullptr )
+    {
+        Finish( nullptr );
+        return;
+    }
+
+    auto * actor_pool_system = world->GetSubsystem< UActorPoolSubSystem >();
+
+    if ( actor_pool_system == nullptr )
+    {
+        Finish( nullptr );
+        return;
+    }
+
+    const auto actor_class = ActorClass.Get();
+
+    // The pool only mirrors the server and will never give an actor on this side of the network
+    if ( actor_pool_system->IsPoolDrivenByServer( actor_class ) )
+    {
+        Finish( nullptr );
+        return;
+    }
+
+    // Without a pool yet, wait for it to be registered until the timeout.
+    // An empty pool grows synchronously, so the growth is spread over the frames and only charged when an instance was spawned
+    if ( actor_pool_system->IsActorClassPoolable( actor_class ) && ( actor_pool_system->GetIdleInstanceCount( actor_class ) > 0 || HasGrowthBudget() ) )
+    {
+        const auto instance_count = actor_pool_system->GetInstanceCount( actor_class );
+
+        RequestHandle = actor_pool_system->GetActorFromPoolWithTransform( actor_class, Transform, FAPOnActorGotFromPoolDelegate::CreateUObject( this, &ThisClass::OnActorGotFromPool ), CallerTag );
+
+        if ( actor_pool_system->GetInstanceCount( actor_class ) > instance_count )
+        {
+            ConsumeGrowthBudget();
+        }
+
+        // Either the actor has been given already, or it will be given when its deferred acquisition is finished
+        if ( bIsFinished || RequestHandle.IsValid() )
+        {
+            return;
+        }
+    }
+
+    world->GetTimerManager().SetTimerForNextTick( FTimerDelegate::CreateUObject( this, &ThisClass::TryAcquireActor ) );
+}
+
+void UAPAsyncAction_GetActorFromPool::OnActorGotFromPool( AActor * actor )
+{
+    Finish( actor );
+}
+
+void UAPAsyncAction_GetActorFromPool::OnTimeout()
+{
+    // A deferred acquisition which is not finished in time is cancelled, so its actor goes back to the pool instead of leaking
+    if ( RequestHandle.IsValid() )
+    {
+        if ( auto * world = World.Get() )
+        {
+            if ( auto * actor_pool_system = world->GetSubsystem< UActorPoolSubSystem >() )
+            {
+                actor_pool_system->CancelAcquireActor( RequestHandle, CallerTag );
+            }
+        }
+
+        RequestHandle = FActorPoolRequestHandle();
+    }
+
+    Finish( nullptr );
+}
+
+void UAPAsyncAction_GetActorFromPool::Finish( AActor * actor )
+{
+    if ( bIsFinished )
+    {
+        return;
+    }
+
+    bIsFinished = true;
+
+    if ( auto * world = World.Get() )
+    {
+        world->GetTimerManager().ClearTimer( TimeoutTimerHandle );
+    }
+
+    if ( StreamableHandle.IsValid() )
+    {
+        StreamableHandle->CancelHandle();
+        StreamableHandle.Reset();
+    }
+
+    Completed.Broadcast( actor );
+    SetReadyToDestroy();
+}
+
+bool UAPAsyncAction_GetActorFromPool::HasGrowthBudget() const
+{
+    return GetGrowthCountOfFrame() < GActorPoolAsyncGrowthBudgetPerFrame.GetValueOnGameThread();
+}
+
+void UAPAsyncAction_GetActorFromPool::ConsumeGrowthBudget() const
+{
+    GetGrowthCountOfFrame()++;
+}
+
+int32 & UAPAsyncAction_GetActorFromPool::GetGrowthCountOfFrame()
+{
+    static uint64 GGrowthFrame = 0;
+    static int32 GGrowthCount = 0;
+
+    if ( GGrowthFrame != GFrameCounter )
+    {
+        GGrowthFrame = GFrameCounter;
+        GGrowthCount = 0;
+    }
+
+    return GGrowthCount;
+}
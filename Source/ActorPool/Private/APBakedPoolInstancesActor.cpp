@@ -0,0 +1,123 @@
+#include "APBakedPoolInstancesActor.h"
+
+#include "ActorPoolActor.h"
+#include "ActorPoolLog.h"
+#include "ActorPoolSettings.h"
+
+#include <Components/SceneComponent.h>
+#include <Engine/World.h>
+
+#if WITH_EDITOR
+#include <ScopedTransaction.h>
+#endif
+
+AAPBakedPoolInstancesActor::AAPBakedPoolInstancesActor()
+{
+    PrimaryActorTick.bCanEverTick = false;
+
+    RootComponent = CreateDefaultSubobject< USceneComponent >( TEXT( "Root" ) );
+}
+
+TArray< AActor * > AAPBakedPoolInstancesActor::TakeBakedInstances( const UClass * actor_class )
+{
+    TArray< AActor * > result;
+
+    BakedInstances.RemoveAll( [ & ]( AActor * instance ) {
+        if ( !IsValid( instance ) )
+        {
+            return true;
+        }
+
+        if ( instance->GetClass() != actor_class )
+        {
+            return false;
+        }
+
+        result.Add( instance );
+        return true;
+    } );
+
+    return result;
+}
+
+#if WITH_EDITOR
+void AAPBakedPoolInstancesActor::BakePoolInstances()
+{
+    const FScopedTransaction transaction( NSLOCTEXT( "ActorPool", "BakePoolInstances", "Bake Pool Instances" ) );
+
+    ClearBakedInstances();
+
+    const auto * settings = GetDefault< UActorPoolSettings >();
+
+    for ( const auto & pool_infos : settings->PoolInfos )
+    {
+        if ( ActorClasses.Num() > 0 && !ActorClasses.Contains( pool_infos.ActorClass ) )
+        {
+            continue;
+        }
+
+        auto * actor_class = pool_infos.ActorClass.LoadSynchronous();
+
+        if ( actor_class == nullptr )
+        {
+            continue;
+        }
+
+        // Replicated actors loaded with a level are matched by name between the server and the clients, which the pools can't guarantee
+        if ( actor_class->GetDefaultObject< AActor >()->GetIsReplicated() )
+        {
+            UE_LOG( LogActorPool, Warning, TEXT( "BakePoolInstances : %s replicates and can't be baked in a level" ), *actor_class->GetName() );
+            continue;
+        }
+
+        FActorSpawnParameters spawn_parameters;
+        spawn_parameters.OverrideLevel = GetLevel();
+        spawn_parameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+        auto spawn_transform = GetActorTransform();
+        const auto folder_path = FName( *FString::Printf( TEXT( "ActorPool/%s" ), *actor_class->GetName() ) );
+
+        auto baked_count = 0;
+
+        for ( auto index = 0; index < pool_infos.Count; ++index )
+        {
+            // Spread over the parking grid like the instances spawned at runtime, so their bodies don't overlap when they load
+            if ( pool_infos.bUseParkingLocation )
+            {
+                spawn_transform = FTransform( pool_infos.ParkingTransform.GetRotation(), FActorPoolInstances::GetParkingLocation( pool_infos, index ) );
+            }
+
+            if ( auto * instance = GetWorld()->SpawnActor< AActor >( actor_class, spawn_transform, spawn_parameters ) )
+            {
+                instance->SetActorHiddenInGame( true );
+                instance->SetActorEnableCollision( false );
+                instance->SetFolderPath( folder_path );
+                BakedInstances.Add( instance );
+                baked_count++;
+            }
+        }
+
+        UE_LOG( LogActorPool, Log, TEXT( "BakePoolInstances : Baked %i instances of %s" ), baked_count, *actor_class->GetName() );
+    }
+
+    MarkPackageDirty();
+}
+
+void AAPBakedPoolInstancesActor::ClearBakedInstances()
+{
+    const FScopedTransaction transaction( NSLOCTEXT( "ActorPool", "ClearBakedInstances", "Clear Baked Pool Instances" ) );
+
+    Modify();
+
+    for ( auto * instance : BakedInstances )
+    {
+        if ( IsValid( instance ) )
+        {
+            GetWorld()->EditorDestroyActor( instance, true );
+        }
+    }
+
+    BakedInstances.Reset();
+    MarkPackageDirty();
+}
+#endif
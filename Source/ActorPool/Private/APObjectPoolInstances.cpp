@@ -0,0 +1,280 @@
+#include "APObjectPoolInstances.h"
+
+#include "APPooledActorInterface.h"
+#include "ActorPoolLog.h"
+
+#include <Components/ActorComponent.h>
+#include <Components/SceneComponent.h>
+#include <GameFramework/Actor.h>
+
+FAPObjectPoolInstances::FAPObjectPoolInstances() :
+    Outer( nullptr ),
+    InstanceMemorySize( 0 )
+{
+}
+
+FAPObjectPoolInstances::FAPObjectPoolInstances( UObject * outer, const FAPObjectPoolInfos & pool_infos ) :
+    Outer( outer ),
+    PoolInfos( pool_infos ),
+    InstanceMemorySize( 0 )
+{
+    Instances.Reserve( pool_infos.Count );
+
+    if ( PoolInfos.bResetToArchetypeOnReturn )
+    {
+        ArchetypeSnapshot.Initialize( PoolInfos.ObjectClass.LoadSynchronous() );
+    }
+
+    for ( auto index = 0; index < pool_infos.Count; ++index )
+    {
+        CreateObjectAndAddToInstances();
+    }
+
+    UE_LOG( LogActorPool, Verbose, TEXT( "Created %i instances for %s" ), GetInstanceCount(), *PoolInfos.ObjectClass.ToString() );
+}
+
+UObject * FAPObjectPoolInstances::GetAvailableInstance( USceneComponent * attach_parent, FName socket_name, FName caller_tag )
+{
+    const auto acquire_time = FPlatformTime::Seconds();
+    auto is_recycled = false;
+
+    const auto slot_index = Slots.AcquireSlotWithPolicy( PoolInfos.PoolingPolicy, false, acquire_time, caller_tag, [ & ]() {
+        return CreateObjectAndAddToInstances() != nullptr;
+    }, is_recycled );
+
+    if ( slot_index == INDEX_NONE )
+    {
+        return nullptr;
+    }
+
+    if ( is_recycled )
+    {
+        // The recycled component is destroyed with the actor it was attached to, else it is still registered and attached to it
+        if ( IsValid( Instances[ slot_index ] ) )
+        {
+            DisableObject( Instances[ slot_index ] );
+        }
+        else
+        {
+            Instances[ slot_index ] = CreateObject();
+        }
+    }
+
+    auto * result = Instances[ slot_index ];
+
+    if ( result == nullptr )
+    {
+        Slots.RemoveSlot( slot_index );
+        return nullptr;
+    }
+    EnableObject( result, attach_parent, socket_name );
+
+    UE_LOG( LogActorPool, Verbose, TEXT( "GetAvailableInstance : %s - Slot : %i - Available Instance Count : %i" ), *GetNameSafe( result ), slot_index, Slots.GetAvailableSlotCount() );
+
+    return result;
+}
+
+bool FAPObjectPoolInstances::ReturnObject( UObject * object, FName caller_tag )
+{
+    if ( object == nullptr )
+    {
+        return false;
+    }
+
+    const auto slot_index = Instances.Find( object );
+
+    if ( slot_index == INDEX_NONE )
+    {
+        UE_LOG( LogActorPool, Warning, TEXT( "ReturnObject : %s is not an instance of the pool of %s - Caller : %s" ), *GetNameSafe( object ), *PoolInfos.ObjectClass.ToString(), *caller_tag.ToString() );
+        return false;
+    }
+
+    if ( !Slots.ReleaseSlot( slot_index ) )
+    {
+        UE_LOG( LogActorPool, Warning, TEXT( "ReturnObject : %s has already been returned to the pool - Caller : %s - Last acquired by : %s" ), *GetNameSafe( object ), *caller_tag.ToString(), *Slots.GetSlot( slot_index ).CallerTag.ToString() );
+        return false;
+    }
+
+    if ( ArchetypeSnapshot.IsValid() )
+    {
+        ArchetypeSnapshot.RestoreArchetypeValues( object );
+    }
+
+    DisableObject( object );
+
+    UE_LOG( LogActorPool, Verbose, TEXT( "ReturnObject : %s - Slot : %i - Available Instance Count : %i" ), *GetNameSafe( object ), slot_index, Slots.GetAvailableSlotCount() );
+
+    return true;
+}
+
+void FAPObjectPoolInstances::DestroyObjects()
+{
+    for ( auto * instance : Instances )
+    {
+        DestroyObject( instance );
+    }
+
+    Instances.Reset();
+    Slots.Reset();
+}
+
+void FAPObjectPoolInstances::DestroyUnusedInstances()
+{
+    while ( Slots.GetAvailableSlotCount() > 0 )
+    {
+        const auto slot_index = Slots.GetLastAvailableSlotIndex();
+
+        DestroyObject( Instances[ slot_index ] );
+        Instances[ slot_index ] = nullptr;
+        Slots.RemoveSlot( slot_index );
+    }
+}
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+void FAPObjectPoolInstances::ReportHeldInstances( double now )
+{
+    if ( PoolInfos.MaxHeldDuration <= 0.0f )
+    {
+        return;
+    }
+
+    for ( const auto slot_index : Slots.ReportSlotsHeldLongerThan( now, PoolInfos.MaxHeldDuration ) )
+    {
+        const auto & slot = Slots.GetSlot( slot_index );
+        UE_LOG( LogActorPool, Warning, TEXT( "%s has been held for %.1f seconds, more than the %.1f seconds allowed by its pool - Caller : %s" ), *GetNameSafe( Instances[ slot_index ] ), now - slot.AcquireTime, PoolInfos.MaxHeldDuration, *slot.CallerTag.ToString() );
+    }
+}
+
+void FAPObjectPoolInstances::DumpHeldInstancesAges( FOutputDevice & output_device, double now ) const
+{
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "Object pool for class %s - Acquired Instance Count : %i" ), *PoolInfos.ObjectClass.ToString(), Slots.GetAcquiredSlotCount() );
+    Slots.DumpAcquiredSlotsAges( output_device, now );
+}
+
+void FAPObjectPoolInstances::DumpPoolInfos( FOutputDevice & output_device ) const
+{
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "Object pool for class %s" ), *PoolInfos.ObjectClass.ToString() );
+    Slots.DumpSlotCounts( output_device );
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Estimated Memory : %.1f KB (%.1f KB per instance)" ), GetMemorySize() / 1024.0, InstanceMemorySize / 1024.0 );
+}
+#endif
+
+UObject * FAPObjectPoolInstances::CreateObject() const
+{
+    auto * object_class = PoolInfos.ObjectClass.LoadSynchronous();
+
+    if ( object_class == nullptr || Outer == nullptr )
+    {
+        return nullptr;
+    }
+
+    // Components must be outered to an actor to be registered
+    if ( object_class->IsChildOf( UActorComponent::StaticClass() ) && !Outer->IsA< AActor >() )
+    {
+        UE_LOG( LogActorPool, Warning, TEXT( "CreateObject : %s is a component class and must be pooled by an actor" ), *object_class->GetName() );
+        return nullptr;
+    }
+
+    return NewObject< UObject >( Outer, object_class, NAME_None, RF_Transient );
+}
+
+UObject * FAPObjectPoolInstances::CreateObjectAndAddToInstances()
+{
+    auto * object = CreateObject();
+
+    if ( object == nullptr )
+    {
+        return nullptr;
+    }
+
+    const auto slot_index = Slots.AddSlot();
+
+    if ( slot_index >= Instances.Num() )
+    {
+        Instances.SetNum( slot_index + 1 );
+    }
+
+    Instances[ slot_index ] = object;
+
+    if ( InstanceMemorySize == 0 )
+    {
+        InstanceMemorySize = static_cast< int64 >( object->GetClass()->GetStructureSize() ) + object->GetResourceSizeBytes( EResourceSizeMode::Exclusive );
+    }
+
+    return object;
+}
+
+void FAPObjectPoolInstances::EnableObject( UObject * object, USceneComponent * attach_parent, FName socket_name ) const
+{
+    if ( auto * component = Cast< UActorComponent >( object ) )
+    {
+        if ( attach_parent != nullptr )
+        {
+            // While acquired, the component is owned by the actor of attach_parent, so GetOwner returns that actor and it is registered with it
+            auto * attach_owner = attach_parent->GetOwner();
+
+            if ( attach_owner != nullptr && component->GetOuter() != attach_owner )
+            {
+                component->Rename( nullptr, attach_owner, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional );
+            }
+
+            if ( auto * scene_component = Cast< USceneComponent >( component ) )
+            {
+                scene_component->AttachToComponent( attach_parent, FAttachmentTransformRules::SnapToTargetNotIncludingScale, socket_name );
+            }
+        }
+
+        component->RegisterComponent();
+        component->Activate( true );
+    }
+
+    if ( object->Implements< UAPPooledActorInterface >() )
+    {
+        IAPPooledActorInterface::Execute_OnAcquiredFromPool( object );
+    }
+}
+
+void FAPObjectPoolInstances::DisableObject( UObject * object ) const
+{
+    if ( object->Implements< UAPPooledActorInterface >() )
+    {
+        IAPPooledActorInterface::Execute_OnReturnedToPool( object );
+    }
+
+    if ( auto * component = Cast< UActorComponent >( object ) )
+    {
+        component->Deactivate();
+
+        if ( auto * scene_component = Cast< USceneComponent >( component ) )
+        {
+            scene_component->DetachFromComponent( FDetachmentTransformRules::KeepRelativeTransform );
+        }
+
+        if ( component->IsRegistered() )
+        {
+            component->UnregisterComponent();
+        }
+
+        if ( component->GetOuter() != Outer )
+        {
+            component->Rename( nullptr, Outer, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional );
+        }
+    }
+}
+
+void FAPObjectPoolInstances::DestroyObject( UObject * object )
+{
+    if ( !IsValid( object ) )
+    {
+        return;
+    }
+
+    if ( auto * component = Cast< UActorComponent >( object ) )
+    {
+        component->DestroyComponent();
+    }
+    else
+    {
+        object->MarkAsGarbage();
+    }
+}
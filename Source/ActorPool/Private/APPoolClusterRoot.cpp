@@ -0,0 +1,37 @@
+#include "APPoolClusterRoot.h"
+
+#include <GameFramework/Actor.h>
+#include <UObject/UObjectArray.h>
+
+bool UAPPoolClusterRoot::CanBeClusterRoot() const
+{
+    return true;
+}
+
+void UAPPoolClusterRoot::Rebuild( const TArray< AActor * > & instances )
+{
+    Dissolve();
+
+    Instances = instances;
+
+    if ( Instances.Num() > 0 )
+    {
+        // Only the objects which can be in a cluster are added to it, the garbage collector still walks the others
+        CreateCluster();
+    }
+}
+
+void UAPPoolClusterRoot::Dissolve()
+{
+    if ( IsClustered() )
+    {
+        GUObjectClusters.DissolveCluster( this );
+    }
+
+    Instances.Reset();
+}
+
+bool UAPPoolClusterRoot::IsClustered() const
+{
+    return HasAnyInternalFlags( EInternalObjectFlags::ClusterRoot );
+}
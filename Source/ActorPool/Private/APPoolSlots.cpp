@@ -0,0 +1,318 @@
+#include "APPoolSlots.h"
+
+#include <HAL/IConsoleManager.h>
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+static TAutoConsoleVariable< int32 > GActorPoolForceInstanceCreationWhenPoolIsEmpty(
+    TEXT( "ActorPool.ForceInstanceCreationWhenPoolIsEmpty" ),
+    0,
+    TEXT( "When on, will force to create actor instances when the pool is empty.\n" )
+        TEXT( "0: Disable, 1: Enable" ),
+    ECVF_Default );
+#endif
+
+FAPPoolSlot::FAPPoolSlot() :
+    AcquireTime( 0.0 ),
+    Generation( 0 ),
+    PreviousIndex( INDEX_NONE ),
+    NextIndex( INDEX_NONE ),
+    State( EAPPoolSlotState::Empty ),
+    bIsReportedAsHeld( false )
+{
+}
+
+int FAPPoolSlots::AddSlot()
+{
+    const auto slot_index = EmptySlotIndices.Num() > 0
+                                ? EmptySlotIndices.Pop( false )
+                                : Slots.AddDefaulted();
+
+    // The generation of an empty slot is kept, so the references to its previous instance stay invalid
+    auto & slot = Slots[ slot_index ];
+    const auto generation = slot.Generation;
+    slot = FAPPoolSlot();
+    slot.Generation = generation;
+    slot.State = EAPPoolSlotState::Available;
+
+    LinkSlot( AvailableSlots, slot_index );
+
+    return slot_index;
+}
+
+void FAPPoolSlots::RemoveSlot( int slot_index )
+{
+    auto & slot = Slots[ slot_index ];
+
+    switch ( slot.State )
+    {
+        case EAPPoolSlotState::Available:
+        {
+            UnlinkSlot( AvailableSlots, slot_index );
+        }
+        break;
+        case EAPPoolSlotState::Acquired:
+        {
+            UnlinkSlot( AcquiredSlots, slot_index );
+        }
+        break;
+        default:
+        {
+            return;
+        }
+    }
+
+    const auto generation = slot.Generation + 1;
+    slot = FAPPoolSlot();
+    slot.Generation = generation;
+    EmptySlotIndices.Add( slot_index );
+}
+
+void FAPPoolSlots::Reset()
+{
+    Slots.Reset();
+    EmptySlotIndices.Reset();
+    AvailableSlots = SlotList();
+    AcquiredSlots = SlotList();
+}
+
+int FAPPoolSlots::AcquireSlot( double acquire_time, FName caller_tag )
+{
+    const auto slot_index = AvailableSlots.Tail;
+
+    if ( slot_index == INDEX_NONE )
+    {
+        return INDEX_NONE;
+    }
+
+    UnlinkSlot( AvailableSlots, slot_index );
+    LinkSlot( AcquiredSlots, slot_index );
+    MarkAcquired( slot_index, acquire_time, caller_tag );
+
+    return slot_index;
+}
+
+int FAPPoolSlots::ReacquireOldestSlot( double acquire_time, FName caller_tag )
+{
+    const auto slot_index = AcquiredSlots.Head;
+
+    if ( slot_index == INDEX_NONE )
+    {
+        return INDEX_NONE;
+    }
+
+    UnlinkSlot( AcquiredSlots, slot_index );
+    LinkSlot( AcquiredSlots, slot_index );
+    Slots[ slot_index ].Generation++;
+    MarkAcquired( slot_index, acquire_time, caller_tag );
+
+    return slot_index;
+}
+
+int FAPPoolSlots::AcquireSlotWithPolicy( EAPPoolingPolicy pooling_policy, bool must_grow, double acquire_time, FName caller_tag, TFunctionRef< bool() > create_instance, bool & is_recycled )
+{
+    is_recycled = false;
+
+    const auto slot_index = AcquireSlot( acquire_time, caller_tag );
+
+    if ( slot_index != INDEX_NONE )
+    {
+        return slot_index;
+    }
+
+    if ( must_grow || IsInstanceCreationForced() )
+    {
+        pooling_policy = EAPPoolingPolicy::CreateNewInstances;
+    }
+
+    switch ( pooling_policy )
+    {
+        case EAPPoolingPolicy::CreateNewInstances:
+        {
+            return create_instance() ? AcquireSlot( acquire_time, caller_tag ) : INDEX_NONE;
+        }
+        case EAPPoolingPolicy::LoopInstances:
+        {
+            is_recycled = AcquiredSlots.Count > 0;
+            return ReacquireOldestSlot( acquire_time, caller_tag );
+        }
+        default:
+        {
+            checkNoEntry();
+        }
+        break;
+    }
+
+    return INDEX_NONE;
+}
+
+bool FAPPoolSlots::AcquireSlotAt( int slot_index, double acquire_time, FName caller_tag )
+{
+    if ( !Slots.IsValidIndex( slot_index ) || Slots[ slot_index ].State != EAPPoolSlotState::Available )
+    {
+        return false;
+    }
+
+    UnlinkSlot( AvailableSlots, slot_index );
+    LinkSlot( AcquiredSlots, slot_index );
+    MarkAcquired( slot_index, acquire_time, caller_tag );
+
+    return true;
+}
+
+bool FAPPoolSlots::ReleaseSlot( int slot_index )
+{
+    if ( !Slots.IsValidIndex( slot_index ) || Slots[ slot_index ].State != EAPPoolSlotState::Acquired )
+    {
+        return false;
+    }
+
+    UnlinkSlot( AcquiredSlots, slot_index );
+    LinkSlot( AvailableSlots, slot_index );
+    Slots[ slot_index ].State = EAPPoolSlotState::Available;
+    Slots[ slot_index ].Generation++;
+
+    return true;
+}
+
+bool FAPPoolSlots::IsInstanceCreationForced()
+{
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+    return GActorPoolForceInstanceCreationWhenPoolIsEmpty.GetValueOnGameThread() != 0;
+#else
+    return false;
+#endif
+}
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+void FAPPoolSlots::DumpSlotCounts( FOutputDevice & output_device ) const
+{
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Total Instance Count : %i" ), AvailableSlots.Count + AcquiredSlots.Count );
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Alive Instance Count : %i" ), AcquiredSlots.Count );
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Available Instance Count : %i" ), AvailableSlots.Count );
+}
+
+TArray< int > FAPPoolSlots::ReportSlotsHeldLongerThan( double now, double max_held_duration )
+{
+    TArray< int > result;
+
+    // The acquired slots are sorted from the oldest to the most recent, so we can stop at the first one which is not held for too long
+    for ( auto slot_index = AcquiredSlots.Head; slot_index != INDEX_NONE; slot_index = Slots[ slot_index ].NextIndex )
+    {
+        auto & slot = Slots[ slot_index ];
+
+        if ( now - slot.AcquireTime < max_held_duration )
+        {
+            break;
+        }
+
+        if ( !slot.bIsReportedAsHeld )
+        {
+            slot.bIsReportedAsHeld = true;
+            result.Add( slot_index );
+        }
+    }
+
+    return result;
+}
+
+void FAPPoolSlots::DumpAcquiredSlotsAges( FOutputDevice & output_device, double now ) const
+{
+    static const double BucketUpperBounds[] = { 1.0, 5.0, 30.0, 60.0, 300.0 };
+    constexpr auto BucketCount = UE_ARRAY_COUNT( BucketUpperBounds ) + 1;
+
+    int bucket_counts[ BucketCount ] = {};
+
+    for ( auto slot_index = AcquiredSlots.Head; slot_index != INDEX_NONE; slot_index = Slots[ slot_index ].NextIndex )
+    {
+        const auto held_duration = now - Slots[ slot_index ].AcquireTime;
+        auto bucket_index = 0;
+
+        while ( bucket_index < UE_ARRAY_COUNT( BucketUpperBounds ) && held_duration >= BucketUpperBounds[ bucket_index ] )
+        {
+            bucket_index++;
+        }
+
+        bucket_counts[ bucket_index ]++;
+    }
+
+    for ( auto bucket_index = 0; bucket_index < BucketCount; ++bucket_index )
+    {
+        if ( bucket_index < UE_ARRAY_COUNT( BucketUpperBounds ) )
+        {
+            output_device.Logf( ELogVerbosity::Verbose, TEXT( "   < %.0fs : %i" ), BucketUpperBounds[ bucket_index ], bucket_counts[ bucket_index ] );
+        }
+        else
+        {
+            output_device.Logf( ELogVerbosity::Verbose, TEXT( "   >= %.0fs : %i" ), BucketUpperBounds[ bucket_index - 1 ], bucket_counts[ bucket_index ] );
+        }
+    }
+
+    if ( AcquiredSlots.Head != INDEX_NONE )
+    {
+        const auto & oldest_slot = Slots[ AcquiredSlots.Head ];
+        output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Oldest : %.1fs - Caller : %s" ), now - oldest_slot.AcquireTime, *oldest_slot.CallerTag.ToString() );
+    }
+}
+#endif
+
+void FAPPoolSlots::MarkAcquired( int slot_index, double acquire_time, FName caller_tag )
+{
+    auto & slot = Slots[ slot_index ];
+    slot.State = EAPPoolSlotState::Acquired;
+    slot.AcquireTime = acquire_time;
+    slot.CallerTag = caller_tag;
+    slot.bIsReportedAsHeld = false;
+}
+
+void FAPPoolSlots::LinkSlot( SlotList & slot_list, int slot_index )
+{
+    auto & slot = Slots[ slot_index ];
+    slot.PreviousIndex = slot_list.Tail;
+    slot.NextIndex = INDEX_NONE;
+
+    if ( slot_list.Tail != INDEX_NONE )
+    {
+        Slots[ slot_list.Tail ].NextIndex = slot_index;
+    }
+    else
+    {
+        slot_list.Head = slot_index;
+    }
+
+    slot_list.Tail = slot_index;
+    slot_list.Count++;
+}
+
+void FAPPoolSlots::UnlinkSlot( SlotList & slot_list, int slot_index )
+{
+    auto & slot = Slots[ slot_index ];
+
+    if ( slot.PreviousIndex != INDEX_NONE )
+    {
+        Slots[ slot.PreviousIndex ].NextIndex = slot.NextIndex;
+    }
+    else
+    {
+        slot_list.Head = slot.NextIndex;
+    }
+
+    if ( slot.NextIndex != INDEX_NONE )
+    {
+        Slots[ slot.NextIndex ].PreviousIndex = slot.PreviousIndex;
+    }
+    else
+    {
+        slot_list.Tail = slot.PreviousIndex;
+    }
+
+    slot.PreviousIndex = INDEX_NONE;
+    slot.NextIndex = INDEX_NONE;
+    slot_list.Count--;
+}
+
+FAPPoolSlots::SlotList::SlotList() :
+    Head( INDEX_NONE ),
+    Tail( INDEX_NONE ),
+    Count( 0 )
+{
+}
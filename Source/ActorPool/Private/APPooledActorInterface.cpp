@@ -1 +1,6 @@
-#include "APPooledActorInterface.h"
\ No newline at end of file
+#include "APPooledActorInterface.h"
+
+bool IAPPooledActorInterface::ApplyAcquirePayload( const FTransform & /*transform*/, const FInstancedStruct & /*payload*/ )
+{
+    return false;
+}
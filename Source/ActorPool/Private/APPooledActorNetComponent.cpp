@@ -0,0 +1,40 @@
+#include "APPooledActorNetComponent.h"
+
+#include "ActorPoolSubSystem.h"
+
+#include <Engine/World.h>
+#include <Net/UnrealNetwork.h>
+
+UAPPooledActorNetComponent::UAPPooledActorNetComponent() :
+    bIsAcquired( false )
+{
+    PrimaryComponentTick.bCanEverTick = false;
+    SetIsReplicatedByDefault( true );
+}
+
+void UAPPooledActorNetComponent::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & lifetime_properties ) const
+{
+    Super::GetLifetimeReplicatedProps( lifetime_properties );
+
+    DOREPLIFETIME( UAPPooledActorNetComponent, bIsAcquired );
+}
+
+void UAPPooledActorNetComponent::SetIsAcquired( const bool is_acquired )
+{
+    bIsAcquired = is_acquired;
+}
+
+void UAPPooledActorNetComponent::OnRep_IsAcquired()
+{
+    auto * world = GetWorld();
+
+    if ( world == nullptr )
+    {
+        return;
+    }
+
+    if ( auto * actor_pool_system = world->GetSubsystem< UActorPoolSubSystem >() )
+    {
+        actor_pool_system->MirrorServerInstance( GetOwner(), bIsAcquired );
+    }
+}
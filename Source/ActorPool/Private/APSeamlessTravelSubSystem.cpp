@@ -0,0 +1,70 @@
+#include "APSeamlessTravelSubSystem.h"
+
+#include "ActorPoolLog.h"
+
+#include <Engine/World.h>
+#include <GameFramework/Actor.h>
+
+void UAPSeamlessTravelSubSystem::AddTravelingInstances( const TArray< AActor * > & instances )
+{
+    for ( auto * instance : instances )
+    {
+        TravelingInstances.AddUnique( instance );
+    }
+}
+
+void UAPSeamlessTravelSubSystem::GetTravelingInstances( TArray< AActor * > & actor_list ) const
+{
+    for ( const auto & instance : TravelingInstances )
+    {
+        if ( auto * actor = instance.Get() )
+        {
+            actor_list.AddUnique( actor );
+        }
+    }
+}
+
+TArray< AActor * > UAPSeamlessTravelSubSystem::TakeTravelingInstances( const UWorld * world, const UClass * actor_class )
+{
+    TArray< AActor * > result;
+
+    TravelingInstances.RemoveAll( [ & ]( const TWeakObjectPtr< AActor > & instance ) {
+        auto * actor = instance.Get();
+
+        if ( !IsValid( actor ) )
+        {
+            return true;
+        }
+
+        if ( actor->GetClass() != actor_class || actor->GetWorld() != world )
+        {
+            return false;
+        }
+
+        result.Add( actor );
+        return true;
+    } );
+
+    return result;
+}
+
+void UAPSeamlessTravelSubSystem::DestroyUnclaimedInstances( const UWorld * world )
+{
+    TravelingInstances.RemoveAll( [ world ]( const TWeakObjectPtr< AActor > & instance ) {
+        auto * actor = instance.Get();
+
+        if ( !IsValid( actor ) )
+        {
+            return true;
+        }
+
+        if ( actor->GetWorld() != world )
+        {
+            return false;
+        }
+
+        UE_LOG( LogActorPool, Verbose, TEXT( "Destroying %s which traveled but was not adopted by any pool" ), *actor->GetName() );
+        actor->Destroy();
+        return true;
+    } );
+}
@@ -1,392 +1,2429 @@
 ﻿#include "ActorPoolActor.h"
 
+#include "APBakedPoolInstancesActor.h"
 #include "APPooledActorInterface.h"
+#include "APPooledActorNetComponent.h"
+#include "APSeamlessTravelSubSystem.h"
 #include "ActorPoolLog.h"
 #include "ActorPoolSubSystem.h"
 
+#include <Components/InstancedStaticMeshComponent.h>
+#include <Components/PrimitiveComponent.h>
 #include <Engine/Engine.h>
+#include <Engine/GameInstance.h>
+#include <Engine/Level.h>
 #include <Engine/World.h>
+#include <EngineUtils.h>
 #include <Kismet/KismetSystemLibrary.h>
+#include <TimerManager.h>
 
-#if WITH_EDITOR
-#include <Engine/GameInstance.h>
-#endif
+static TAutoConsoleVariable< int32 > GActorPoolClusterIdleInstances(
+    TEXT( "ActorPool.ClusterIdleInstances" ),
+    1,
+    TEXT( "When on, the idle instances of the pools with bClusterIdleInstances are grouped in a garbage collection cluster.\n" )
+        TEXT( "0: Never cluster the idle instances, 1: Use the pool settings" ),
+    ECVF_Default );
 
-#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
-static TAutoConsoleVariable< int32 > GActorPoolForceInstanceCreationWhenPoolIsEmpty(
-    TEXT( "ActorPool.ForceInstanceCreationWhenPoolIsEmpty" ),
-    0,
-    TEXT( "When on, will force to create actor instances when the pool is empty.\n" )
-        TEXT( "0: Disable, 1: Enable" ),
+static TAutoConsoleVariable< float > GActorPoolClusterUpdateInterval(
+    TEXT( "ActorPool.ClusterUpdateInterval" ),
+    2.0f,
+    TEXT( "Interval in seconds between two updates of the clusters of the idle instances. Acquiring or returning an instance dissolves the cluster of its pool, which is rebuilt once the pool has been untouched for that long." ),
+    ECVF_Default );
+
+static TAutoConsoleVariable< int32 > GActorPoolResizeBudgetPerFrame(
+    TEXT( "ActorPool.ResizeBudgetPerFrame" ),
+    4,
+    TEXT( "Maximum number of instances spawned or destroyed per frame when the pools are resized after a change of ActorPool.CountScale or of the device profile." ),
+    ECVF_Default );
+
+static TAutoConsoleVariable< float > GActorPoolUnclaimedTravelingInstancesLifetime(
+    TEXT( "ActorPool.UnclaimedTravelingInstancesLifetime" ),
+    10.0f,
+    TEXT( "Delay in seconds after the pools are ready before the instances which traveled seamlessly and were not adopted by any pool are destroyed.\n" )
+        TEXT( "It leaves time to the pools registered later, like the ones of the game feature actions or of the streaming levels, to adopt their instances." ),
     ECVF_Default );
 
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
 static TAutoConsoleVariable< int32 > GActorPoolDisable(
     TEXT( "ActorPool.Disable" ),
     0,
     TEXT( "When on, will not create any instances.\n" )
         TEXT( "0: Enable the pools, 1: Disable the pools" ),
     ECVF_Default );
+
+static TAutoConsoleVariable< float > GActorPoolHeldInstancesScanInterval(
+    TEXT( "ActorPool.HeldInstancesScanInterval" ),
+    5.0f,
+    TEXT( "Interval in seconds between two scans of the instances held longer than the MaxHeldDuration of their pool.\n" )
+        TEXT( "0: Disable the scan" ),
+    ECVF_Default );
 #endif
 
 FActorPoolInstances::FActorPoolInstances() :
-    AvailableInstanceIndex( 0 )
+    IdleInstancesCluster( nullptr ),
+    ProxyComponent( nullptr ),
+    NextProxyId( 0 ),
+    NextReservationId( 0 ),
+    ReservedCount( 0 ),
+    PoolId( INDEX_NONE ),
+    TargetCount( 0 ),
+    InstanceMemorySize( 0 ),
+    LastAcquireTime( 0.0 ),
+    IdleInstancesChangeTime( 0.0 ),
+    bIsDrivenByServer( false ),
+    bIsIdleInstancesClusterDirty( false ),
+    bIsResizing( false ),
+    bIsShrinkPending( false )
 {
 }
 
-FActorPoolInstances::FActorPoolInstances( UWorld * world, const FActorPoolInfos & pool_infos ) :
-    AvailableInstanceIndex( 0 ),
-    PoolInfos( pool_infos )
+FActorPoolInstances::FActorPoolInstances( UWorld * world, const FActorPoolInfos & pool_infos, int pool_id, const TArray< AActor * > & adopted_instances, bool is_prewarm_deferred ) :
+    IdleInstancesCluster( nullptr ),
+    ProxyComponent( nullptr ),
+    NextProxyId( 0 ),
+    NextReservationId( 0 ),
+    ReservedCount( 0 ),
+    PoolId( pool_id ),
+    PoolInfos( pool_infos ),
+    TargetCount( pool_infos.GetScaledCount() ),
+    InstanceMemorySize( 0 ),
+    // A pool which has just been created counts as recently used, so it is not the first one evicted
+    LastAcquireTime( FPlatformTime::Seconds() ),
+    IdleInstancesChangeTime( 0.0 ),
+    bIsDrivenByServer( pool_infos.bMatchReplicatedInstancesOnClients && world->GetNetMode() == NM_Client ),
+    bIsIdleInstancesClusterDirty( true ),
+    bIsResizing( false ),
+    bIsShrinkPending( false )
 {
-    Instances.Reserve( pool_infos.Count );
+    Instances.Reserve( TargetCount );
+
+    if ( PoolInfos.bResetToArchetypeOnReturn )
+    {
+        ArchetypeSnapshot.Initialize( PoolInfos.ActorClass.LoadSynchronous() );
+    }
+
+    if ( world->GetNetMode() == NM_DedicatedServer )
+    {
+        const auto add_stripped_component_classes = [ & ]( const TArray< TSoftClassPtr< UActorComponent > > & component_classes ) {
+            for ( const auto & component_class : component_classes )
+            {
+                if ( auto * loaded_component_class = component_class.LoadSynchronous() )
+                {
+                    StrippedComponentClasses.AddUnique( loaded_component_class );
+                }
+            }
+        };
+
+        add_stripped_component_classes( GetDefault< UActorPoolSettings >()->DedicatedServerStrippedComponentClasses );
+        add_stripped_component_classes( PoolInfos.DedicatedServerStrippedComponentClasses );
+    }
+
+    for ( auto * actor : adopted_instances )
+    {
+        AdoptInstance( actor );
+    }
 
-    for ( auto index = 0; index < pool_infos.Count; ++index )
+    // The instances matched with the server must be spawned with their prewarm names, so their prewarm is never deferred
+    if ( is_prewarm_deferred && !PoolInfos.bMatchReplicatedInstancesOnClients )
+    {
+        bIsResizing = GetInstanceCount() < GetRequiredCount();
+    }
+    else
     {
-        auto * actor = SpawnActorAndAddToInstances( world );
-        DisableActor( actor );
+        for ( auto index = adopted_instances.Num(); index < TargetCount; ++index )
+        {
+            if ( auto * actor = SpawnActorAndAddToInstances( world, index ) )
+            {
+                DisableActor( actor );
+            }
+        }
     }
 
-    UE_LOG( LogActorPool, Verbose, TEXT( "Created %i instances for %s" ), pool_infos.Count, *PoolInfos.ActorClass.LoadSynchronous()->GetName() );
+    UE_LOG( LogActorPool, Verbose, TEXT( "Created %i instances for %s - Adopted Instance Count : %i" ), GetInstanceCount(), *PoolInfos.ActorClass.LoadSynchronous()->GetName(), adopted_instances.Num() );
 }
 
-AActor * FActorPoolInstances::GetAvailableInstance( UWorld * world )
+AActor * FActorPoolInstances::GetAvailableInstance( UWorld * world, const FTransform & transform, FName caller_tag, const FInstancedStruct * payload )
 {
-    if ( AvailableInstanceIndex == Instances.Num() )
+    const auto acquire_time = FPlatformTime::Seconds();
+    auto is_recycled = false;
+
+    auto slot_index = INDEX_NONE;
+    AActor * result = nullptr;
+
+    // An instance destroyed outside of the pool loses its slot, and the next instance is acquired instead
+    while ( result == nullptr )
     {
-#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
-        if ( GActorPoolForceInstanceCreationWhenPoolIsEmpty.GetValueOnGameThread() )
+        // Until the pool reaches its target plus its reservations, a pool using LoopInstances grows instead of recycling an acquired instance which may be one of the reserved ones
+        slot_index = Slots.AcquireSlotWithPolicy( PoolInfos.PoolingPolicy, GetInstanceCount() < GetRequiredCount(), acquire_time, caller_tag, [ & ]() {
+            return SpawnActorAndAddToInstances( world ) != nullptr;
+        }, is_recycled );
+
+        if ( slot_index == INDEX_NONE )
         {
-            PoolInfos.PoolingPolicy = EAPPoolingPolicy::CreateNewInstances;
+            return nullptr;
         }
-#endif
 
-        switch ( PoolInfos.PoolingPolicy )
+        result = Instances[ slot_index ];
+
+        if ( !IsValid( result ) )
         {
-            case EAPPoolingPolicy::CreateNewInstances:
-            {
-                SpawnActorAndAddToInstances( world );
-            }
-            break;
-            case EAPPoolingPolicy::LoopInstances:
-            {
-                AvailableInstanceIndex = 0;
-            }
-            break;
-            default:
+            UE_LOG( LogActorPool, Warning, TEXT( "GetAvailableInstance : The instance in slot %i of the pool of %s has been destroyed outside of the pool" ), slot_index, *PoolInfos.ActorClass.ToString() );
+            RemoveSlotInstance( slot_index );
+            result = nullptr;
+        }
+    }
+
+    // The objects of a cluster share their reachability, so the acquired instance can't stay in it
+    DissolveIdleInstancesCluster();
+
+    // A recycled instance is taken from an owner which never returned it, so it goes through the return sequence before its new acquisition
+    if ( is_recycled )
+    {
+        if ( auto * actor_pool_system = world->GetSubsystem< UActorPoolSubSystem >() )
+        {
+            actor_pool_system->DropAcquireRequests( result );
+        }
+
+        DisableReturnedActor( result, slot_index );
+
+        UE_LOG( LogActorPool, Verbose, TEXT( "GetAvailableInstance : Recycled %s - Slot : %i" ), *GetNameSafe( result ), slot_index );
+    }
+
+    const auto is_transform_changed = !result->GetActorLocation().Equals( transform.GetLocation() ) || !result->GetActorQuat().Equals( transform.GetRotation() );
+
+    // Teleport before the actor becomes visible and collidable, so the move does not sweep nor inject velocity in the simulating bodies
+    result->SetActorLocationAndRotation( transform.GetLocation(), transform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics );
+
+    if ( PoolInfos.PhysicsParkingMode != EAPPhysicsParkingMode::None || PoolInfos.bIsolateIdleInstances )
+    {
+        UnparkComponents( result );
+    }
+
+    // Called before the payload, so its reset logic does not overwrite the state set by the payload
+    if ( Cast< IAPPooledActorInterface >( result ) )
+    {
+        IAPPooledActorInterface::Execute_OnAcquiredFromPool( result );
+    }
+
+    // The payload is applied in the same pass as the transform, so the actor does not show up with the state of its previous use
+    if ( payload != nullptr && payload->IsValid() )
+    {
+        auto * pooled_actor_interface = Cast< IAPPooledActorInterface >( result );
+
+        if ( pooled_actor_interface == nullptr || !pooled_actor_interface->ApplyAcquirePayload( transform, *payload ) )
+        {
+            if ( result->Implements< UAPPooledActorInterface >() )
             {
-                checkNoEntry();
+                IAPPooledActorInterface::Execute_OnAcquiredFromPoolWithPayload( result, transform, *payload );
             }
-            break;
         }
     }
 
-    auto * result = Instances[ AvailableInstanceIndex ];
-
     result->SetActorHiddenInGame( !PoolInfos.AcquireFromPoolSettings.bShowActor );
+    SetNetAcquired( result, true );
     result->SetActorEnableCollision( PoolInfos.AcquireFromPoolSettings.bEnableCollision );
 
     if ( PoolInfos.AcquireFromPoolSettings.bDisableNetDormancy )
     {
-        result->SetNetDormancy( PoolInfos.AcquireFromPoolSettings.NetDormancy );
+        QueueNetDormancy( result, PoolInfos.AcquireFromPoolSettings.NetDormancy, is_transform_changed );
     }
-
-    if ( Cast< IAPPooledActorInterface >( result ) )
+    else if ( is_transform_changed )
     {
-        IAPPooledActorInterface::Execute_OnAcquiredFromPool( result );
+        // The dormancy queued when the actor was returned in the same frame must be kept
+        QueueForceNetUpdate( result );
     }
 
-    AvailableInstanceIndex++;
+    LastAcquireTime = acquire_time;
 
-    UE_LOG( LogActorPool, Verbose, TEXT( "GetAvailableInstance : %s - AvailableInstanceIndex : %i" ), *GetNameSafe( result ), AvailableInstanceIndex );
+    UE_LOG( LogActorPool, Verbose, TEXT( "GetAvailableInstance : %s - Slot : %i - Available Instance Count : %i" ), *GetNameSafe( result ), slot_index, Slots.GetAvailableSlotCount() );
 
     return result;
 }
 
-bool FActorPoolInstances::ReturnActor( AActor * actor )
+bool FActorPoolInstances::ReturnActor( AActor * actor, FName caller_tag )
 {
     if ( actor == nullptr )
     {
         return false;
     }
 
-    const auto index = Instances.Find( actor );
-
-    if ( index == INDEX_NONE )
-    {
-        return false;
-    }
+    const auto slot_index = FindSlotIndex( actor );
 
-    // We can't let AvailableInstanceIndex go below 0. If we're already at 0 this probably means we're returning an actor that has already been returned already
-    if ( AvailableInstanceIndex == 0 )
+    if ( slot_index == INDEX_NONE )
     {
+        UE_LOG( LogActorPool, Warning, TEXT( "ReturnActor : %s is not an instance of the pool of %s - Caller : %s" ), *GetNameSafe( actor ), *PoolInfos.ActorClass.ToString(), *caller_tag.ToString() );
         return false;
     }
 
-    DisableActor( actor );
+    return ReturnInstance( slot_index, caller_tag );
+}
 
-    check( AvailableInstanceIndex > 0 && AvailableInstanceIndex <= Instances.Num() );
+bool FActorPoolInstances::ReturnInstance( const int slot_index, FName caller_tag )
+{
+    auto * actor = Instances[ slot_index ];
 
-    if ( PoolInfos.PoolingPolicy == EAPPoolingPolicy::LoopInstances && AvailableInstanceIndex == 0 )
+    if ( !Slots.ReleaseSlot( slot_index ) )
     {
-        AvailableInstanceIndex = Instances.Num();
+        UE_LOG( LogActorPool, Warning, TEXT( "ReturnActor : %s has already been returned to the pool - Caller : %s - Last acquired by : %s" ), *GetNameSafe( actor ), *caller_tag.ToString(), *Slots.GetSlot( slot_index ).CallerTag.ToString() );
+        return false;
     }
 
-    AvailableInstanceIndex--;
+    DissolveIdleInstancesCluster();
+    DisableReturnedActor( actor, slot_index );
 
-    if ( Instances.Num() > 1 )
+    // The shrink which stopped because all the instances in excess were acquired resumes as soon as one of them is idle
+    if ( bIsShrinkPending )
     {
-        Instances.RemoveAt( index, 1, false );
-        Instances.Insert( actor, AvailableInstanceIndex );
+        bIsShrinkPending = false;
+        bIsResizing = true;
     }
 
-    UE_LOG( LogActorPool, Verbose, TEXT( "ReturnActor : %s - AvailableInstanceIndex : %i" ), *GetNameSafe( actor ), AvailableInstanceIndex );
+    UE_LOG( LogActorPool, Verbose, TEXT( "ReturnActor : %s - Slot : %i - Available Instance Count : %i" ), *GetNameSafe( actor ), slot_index, Slots.GetAvailableSlotCount() );
 
     return true;
 }
 
-void FActorPoolInstances::DestroyActors()
+int FActorPoolInstances::ReturnInstances( const TArray< FAPPooledActorRef > & refs )
 {
-    for ( auto * instance : Instances )
+    TArray< FAPPooledActorRef > released_refs;
+    released_refs.Reserve( refs.Num() );
+
+    // All the slots are released before any actor is disabled. A reference queued twice only releases its slot once
+    for ( const auto & ref : refs )
     {
-        if ( IsValid( instance ) )
+        if ( ResolveActorRef( ref ) != nullptr && Slots.ReleaseSlot( ref.SlotIndex ) )
         {
-            instance->Destroy();
+            released_refs.Emplace( PoolId, ref.SlotIndex, Slots.GetSlot( ref.SlotIndex ).Generation );
         }
     }
 
-    Instances.Reset();
-    AvailableInstanceIndex = 0;
-}
+    if ( released_refs.Num() == 0 )
+    {
+        return 0;
+    }
 
-void FActorPoolInstances::DestroyUnusedInstances()
-{
-    for ( auto index = AvailableInstanceIndex; index < Instances.Num(); index++ )
+    DissolveIdleInstancesCluster();
+
+    for ( const auto & released_ref : released_refs )
     {
-        if ( auto * instance = Instances[ index ] )
+        const auto & slot = Slots.GetSlot( released_ref.SlotIndex );
+
+        // The events of the actors disabled before may have acquired this one again
+        if ( slot.State != EAPPoolSlotState::Available || slot.Generation != released_ref.Generation )
         {
-            instance->Destroy();
+            continue;
         }
+
+        DisableReturnedActor( Instances[ released_ref.SlotIndex ], released_ref.SlotIndex );
     }
 
-    Instances.SetNum( AvailableInstanceIndex );
-}
+    if ( bIsShrinkPending )
+    {
+        bIsShrinkPending = false;
+        bIsResizing = true;
+    }
 
-#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
-void FActorPoolInstances::DumpPoolInfos( FOutputDevice & output_device ) const
-{
-    output_device.Logf( ELogVerbosity::Verbose, TEXT( "Pool for class %s" ), *PoolInfos.ActorClass.ToString() );
-    output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Total Instance Count : %i" ), PoolInfos.Count );
-    output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Alive Instance Count : %i" ), AvailableInstanceIndex );
-    output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Available Instance Count : %i" ), ( PoolInfos.Count - AvailableInstanceIndex ) );
+    UE_LOG( LogActorPool, Verbose, TEXT( "ReturnInstances : %s - Returned Instance Count : %i - Available Instance Count : %i" ), *PoolInfos.ActorClass.ToString(), released_refs.Num(), Slots.GetAvailableSlotCount() );
+
+    return released_refs.Num();
 }
-#endif
 
-void FActorPoolInstances::DisableActor( AActor * actor ) const
+void FActorPoolInstances::MirrorServerInstance( AActor * instance, const bool is_acquired )
 {
-    actor->SetActorHiddenInGame( true );
-    actor->SetActorEnableCollision( false );
-    actor->SetNetDormancy( ENetDormancy::DORM_DormantAll );
+    const auto slot_index = FindSlotIndex( instance );
 
-    if ( Cast< IAPPooledActorInterface >( actor ) )
+    if ( slot_index == INDEX_NONE )
     {
-        IAPPooledActorInterface::Execute_OnReturnedToPool( actor );
+        return;
     }
-}
 
-AActor * FActorPoolInstances::SpawnActorAndAddToInstances( UWorld * world )
-{
-    FActorSpawnParameters spawn_parameters;
-    spawn_parameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    const auto slot_state = Slots.GetSlot( slot_index ).State;
 
-    auto * actor = world->SpawnActor< AActor >( PoolInfos.ActorClass.LoadSynchronous(), spawn_parameters );
-    Instances.Add( actor );
+    // The transform and the visibility are replicated, but the collision and the interface events are local to each side
+    if ( is_acquired && slot_state == EAPPoolSlotState::Available )
+    {
+        const auto now = FPlatformTime::Seconds();
 
-    return actor;
-}
+        Slots.AcquireSlotAt( slot_index, now, NAME_None );
+        DissolveIdleInstancesCluster();
 
-AActorPoolActor::AActorPoolActor()
-{
-    PrimaryActorTick.bCanEverTick = false;
-}
+        if ( PoolInfos.PhysicsParkingMode != EAPPhysicsParkingMode::None || PoolInfos.bIsolateIdleInstances )
+        {
+            UnparkComponents( instance );
+        }
 
-void AActorPoolActor::BeginPlay()
-{
-    Super::BeginPlay();
+        instance->SetActorEnableCollision( PoolInfos.AcquireFromPoolSettings.bEnableCollision );
 
-    // Initialize the pools
-#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
-    if ( GActorPoolDisable.GetValueOnGameThread() == 0 )
-#endif
-    {
-        if ( auto * settings = GetDefault< UActorPoolSettings >() )
+        if ( Cast< IAPPooledActorInterface >( instance ) )
         {
-            for ( const auto & pool_infos : settings->PoolInfos )
-            {
-                RegisterPooledActor( pool_infos );
-            }
+            IAPPooledActorInterface::Execute_OnAcquiredFromPool( instance );
         }
-    }
 
-    // Register itself to the subsystem
-    if ( auto * actor_pool_system = GetWorld()->GetSubsystem< UActorPoolSubSystem >() )
+        LastAcquireTime = now;
+
+        UE_LOG( LogActorPool, Verbose, TEXT( "MirrorServerInstance : %s acquired by the server - Slot : %i" ), *GetNameSafe( instance ), slot_index );
+    }
+    else if ( !is_acquired && slot_state == EAPPoolSlotState::Acquired )
     {
-        actor_pool_system->RegisterActorPoolActor( this );
+        Slots.ReleaseSlot( slot_index );
+        DissolveIdleInstancesCluster();
+        DisableReturnedActor( instance, slot_index );
+
+        UE_LOG( LogActorPool, Verbose, TEXT( "MirrorServerInstance : %s returned by the server - Slot : %i" ), *GetNameSafe( instance ), slot_index );
     }
 }
 
-void AActorPoolActor::EndPlay( const EEndPlayReason::Type end_play_reason )
+void FActorPoolInstances::SetNetAcquired( AActor * actor, const bool is_acquired ) const
 {
-    for ( auto & key_pair : ActorPools )
+    if ( !PoolInfos.bMatchReplicatedInstancesOnClients || bIsDrivenByServer )
     {
-        key_pair.Value.DestroyActors();
+        return;
     }
 
-    Super::EndPlay( end_play_reason );
+    if ( auto * net_component = actor->FindComponentByClass< UAPPooledActorNetComponent >() )
+    {
+        net_component->SetIsAcquired( is_acquired );
+    }
 }
 
-bool AActorPoolActor::IsActorClassPoolable( TSubclassOf< AActor > actor_class ) const
+void FActorPoolInstances::AdoptInstances( const TArray< AActor * > & instances )
 {
-    if ( actor_class == nullptr )
+    DissolveIdleInstancesCluster();
+
+    for ( auto * actor : instances )
     {
-        return false;
+        AdoptInstance( actor );
     }
 
-    for ( const auto & key_pair : ActorPools )
+    UE_LOG( LogActorPool, Verbose, TEXT( "AdoptInstances : %s - Adopted Instance Count : %i" ), *PoolInfos.ActorClass.ToString(), instances.Num() );
+}
+
+void FActorPoolInstances::ReleaseIdleInstances( TArray< AActor * > & released_instances )
+{
+    DissolveIdleInstancesCluster();
+
+    while ( Slots.GetAvailableSlotCount() > 0 )
     {
-        if ( actor_class == key_pair.Key )
+        const auto slot_index = Slots.GetLastAvailableSlotIndex();
+
+        if ( auto * instance = Instances[ slot_index ] )
         {
-            return true;
+            released_instances.Add( instance );
         }
-    }
 
-    return false;
+        RemoveSlotInstance( slot_index );
+    }
 }
 
-void AActorPoolActor::RegisterPooledActor( const FActorPoolInfos & actor_pool_infos )
+void FActorPoolInstances::ReleaseAcquiredInstances( TArray< AActor * > & released_instances )
 {
-    if ( !ensureAlways( actor_pool_infos.ActorClass != nullptr ) )
+    for ( auto slot_index = 0; slot_index < Instances.Num(); ++slot_index )
     {
-        return;
-    }
+        if ( Slots.GetSlot( slot_index ).State != EAPPoolSlotState::Acquired )
+        {
+            continue;
+        }
 
-    auto * actor_class = actor_pool_infos.ActorClass.LoadSynchronous();
+        if ( auto * instance = Instances[ slot_index ] )
+        {
+            released_instances.Add( instance );
+        }
 
-    if ( !ensureAlways( ActorPools.Find( actor_class ) == nullptr ) )
-    {
-        return;
+        RemoveSlotInstance( slot_index );
     }
+}
 
-    const auto * world = GetWorld();
-    const auto is_standalone = UKismetSystemLibrary::IsStandalone( world );
-    auto is_server = IsRunningDedicatedServer();
+int FActorPoolInstances::RemoveInstancesOfLevel( const ULevel * level )
+{
+    DissolveIdleInstancesCluster();
 
-#if WITH_EDITOR
-    checkSlow( game_instance->GetWorldContext() );
-    is_server |= world->GetGameInstance()->GetWorldContext()->RunAsDedicated;
-#endif
+    auto removed_count = 0;
 
-    const auto is_client = !is_server;
+    // Removing the slots bumps their generation, so the references to the acquired instances of the level stop resolving
+    for ( auto slot_index = 0; slot_index < Instances.Num(); ++slot_index )
+    {
+        const auto * instance = Instances[ slot_index ];
+
+        if ( instance == nullptr || instance->GetLevel() != level )
+        {
+            continue;
+        }
 
-    if ( is_standalone || is_server && actor_pool_infos.bSpawnOnServer || is_client && actor_pool_infos.bSpawnOnClients )
+        RemoveSlotInstance( slot_index );
+        removed_count++;
+    }
+
+    if ( removed_count > 0 )
     {
-        ActorPools.Emplace( actor_class, CreateActorPoolInstance( actor_pool_infos ) );
+        // The instances unloaded with the level are replaced by instances spawned in the persistent level
+        bIsResizing |= GetInstanceCount() < GetRequiredCount();
+
+        UE_LOG( LogActorPool, Verbose, TEXT( "RemoveInstancesOfLevel : %s - Removed Instance Count : %i" ), *PoolInfos.ActorClass.ToString(), removed_count );
     }
+
+    return removed_count;
 }
 
-void AActorPoolActor::UnRegisterPooledActor( const FActorPoolInfos & actor_pool_infos )
+void FActorPoolInstances::UpdateIdleInstancesCluster( UObject * outer )
 {
-    if ( actor_pool_infos.ActorClass == nullptr )
+    if ( !PoolInfos.bClusterIdleInstances || GActorPoolClusterIdleInstances.GetValueOnGameThread() == 0 )
     {
+        DissolveIdleInstancesCluster();
         return;
     }
 
-    auto * actor_class = actor_pool_infos.ActorClass.LoadSynchronous();
-    auto * existing_actor_pool = ActorPools.Find( actor_class );
-
-    if ( existing_actor_pool == nullptr )
+    if ( !bIsIdleInstancesClusterDirty )
     {
         return;
     }
 
-    const auto * world = GetWorld();
-    const auto is_standalone = UKismetSystemLibrary::IsStandalone( world );
-    auto is_server = IsRunningDedicatedServer();
-
-#if WITH_EDITOR
-    checkSlow( game_instance->GetWorldContext() );
-    is_server |= world->GetGameInstance()->GetWorldContext()->RunAsDedicated;
-#endif
-
-    const auto is_client = !is_server;
-
-    if ( is_standalone || is_server && actor_pool_infos.bSpawnOnServer || is_client && actor_pool_infos.bSpawnOnClients )
+    // A cluster rebuilt while the pool is in use would be dissolved again by the next acquisition or return
+    if ( FPlatformTime::Seconds() - IdleInstancesChangeTime < GActorPoolClusterUpdateInterval.GetValueOnGameThread() )
     {
-        existing_actor_pool->DestroyActors();
-        ActorPools.Remove( actor_class );
+        return;
     }
-}
 
-AActor * AActorPoolActor::GetActorFromPool( TSubclassOf< AActor > actor_class )
-{
-    auto * actor_instances = ActorPools.Find( actor_class );
+    TArray< AActor * > idle_instances;
+    idle_instances.Reserve( Slots.GetAvailableSlotCount() );
 
-    if ( actor_instances == nullptr )
+    for ( auto slot_index = 0; slot_index < Instances.Num(); ++slot_index )
     {
-#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
-        if ( GActorPoolForceInstanceCreationWhenPoolIsEmpty.GetValueOnGameThread() == 1 )
+        if ( Slots.GetSlot( slot_index ).State != EAPPoolSlotState::Available )
         {
-            FActorPoolInfos pool_infos;
-            pool_infos.ActorClass = actor_class;
-            pool_infos.Count = 1;
-            pool_infos.PoolingPolicy = EAPPoolingPolicy::CreateNewInstances;
+            continue;
+        }
 
-            actor_instances = &ActorPools.Add( actor_class, FActorPoolInstances( GetWorld(), pool_infos ) );
+        if ( auto * instance = Instances[ slot_index ] )
+        {
+            idle_instances.Add( instance );
         }
-        else
-#endif
+    }
+
+    // A clustered instance must not run any code which could change its references while the garbage collector skips them
+    for ( auto * instance : idle_instances )
+    {
+        if ( instance->IsActorTickEnabled() )
         {
-            return nullptr;
+            instance->SetActorTickEnabled( false );
+            TickDisabledActors.Add( instance );
+        }
+
+        for ( auto * component : instance->GetComponents() )
+        {
+            if ( component != nullptr && component->IsComponentTickEnabled() )
+            {
+                component->SetComponentTickEnabled( false );
+                TickDisabledComponents.Add( component );
+            }
         }
     }
 
-    return actor_instances->GetAvailableInstance( GetWorld() );
+    if ( IdleInstancesCluster == nullptr )
+    {
+        IdleInstancesCluster = NewObject< UAPPoolClusterRoot >( outer );
+    }
+
+    IdleInstancesCluster->Rebuild( idle_instances );
+    bIsIdleInstancesClusterDirty = false;
 }
 
-bool AActorPoolActor::ReturnActorToPool( AActor * actor )
+void FActorPoolInstances::DissolveIdleInstancesCluster()
 {
-    if ( actor == nullptr )
+    if ( IdleInstancesCluster != nullptr )
     {
-        return false;
+        IdleInstancesCluster->Dissolve();
     }
 
-    if ( auto * actor_instances = ActorPools.Find( actor->GetClass() ) )
+    for ( const auto & actor : TickDisabledActors )
     {
-        return actor_instances->ReturnActor( actor );
+        if ( actor.IsValid() )
+        {
+            actor->SetActorTickEnabled( true );
+        }
     }
 
-    return false;
-}
-
-#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
-void AActorPoolActor::DestroyUnusedInstancesInPools()
-{
-    for ( auto & key_pair : ActorPools )
+    for ( const auto & component : TickDisabledComponents )
     {
-        key_pair.Value.DestroyUnusedInstances();
+        if ( component.IsValid() )
+        {
+            component->SetComponentTickEnabled( true );
+        }
     }
+
+    TickDisabledActors.Reset();
+    TickDisabledComponents.Reset();
+
+    bIsIdleInstancesClusterDirty = true;
+    IdleInstancesChangeTime = FPlatformTime::Seconds();
 }
 
-void AActorPoolActor::DumpPoolInfos( FOutputDevice & output_device ) const
+void FActorPoolInstances::SetProxyComponent( UInstancedStaticMeshComponent * proxy_component )
 {
-    output_device.Logf( ELogVerbosity::Verbose, TEXT( "Dumping Actor Pool Infos :" ) );
+    ProxyComponent = proxy_component;
+}
 
-    for ( auto & key_pair : ActorPools )
+int FActorPoolInstances::AcquireProxy( const FTransform & transform )
+{
+    if ( ProxyComponent == nullptr )
     {
-        key_pair.Value.DumpPoolInfos( output_device );
+        return INDEX_NONE;
     }
-}
-#endif
 
-FActorPoolInstances AActorPoolActor::CreateActorPoolInstance( const FActorPoolInfos & pool_infos ) const
+    const auto row = ProxyComponent->AddInstance( transform, true );
+    const auto proxy_id = NextProxyId++;
+
+    check( row == ProxyIdByRow.Num() );
+    ProxyIdByRow.Add( proxy_id );
+    RowByProxyId.Add( proxy_id, row );
+
+    return proxy_id;
+}
+
+bool FActorPoolInstances::ReturnProxy( int proxy_id )
+{
+    return RemoveProxy( proxy_id );
+}
+
+bool FActorPoolInstances::GetProxyTransform( int proxy_id, FTransform & transform ) const
+{
+    const auto * row_ptr = RowByProxyId.Find( proxy_id );
+
+    if ( row_ptr == nullptr || ProxyComponent == nullptr )
+    {
+        return false;
+    }
+
+    return ProxyComponent->GetInstanceTransform( *row_ptr, transform, true );
+}
+
+int FActorPoolInstances::DehydrateActor( AActor * actor, FName caller_tag )
+{
+    if ( ProxyComponent == nullptr || actor == nullptr )
+    {
+        return INDEX_NONE;
+    }
+
+    const auto transform = actor->GetActorTransform();
+
+    if ( !ReturnActor( actor, caller_tag ) )
+    {
+        return INDEX_NONE;
+    }
+
+    return AcquireProxy( transform );
+}
+
+bool FActorPoolInstances::RemoveProxy( int proxy_id )
+{
+    const auto * row_ptr = RowByProxyId.Find( proxy_id );
+
+    if ( row_ptr == nullptr || ProxyComponent == nullptr )
+    {
+        return false;
+    }
+
+    const auto row = *row_ptr;
+    const auto last_row = ProxyIdByRow.Num() - 1;
+
+    // Removing a row in the middle of the instanced static mesh shifts all the following ones, so the last row is moved in place of the removed one instead
+    if ( row != last_row )
+    {
+        FTransform last_transform;
+        ProxyComponent->GetInstanceTransform( last_row, last_transform, true );
+        ProxyComponent->UpdateInstanceTransform( row, last_transform, true, false, true );
+
+        const auto moved_proxy_id = ProxyIdByRow[ last_row ];
+        ProxyIdByRow[ row ] = moved_proxy_id;
+        RowByProxyId[ moved_proxy_id ] = row;
+    }
+
+    ProxyComponent->RemoveInstance( last_row );
+    ProxyIdByRow.Pop( false );
+    RowByProxyId.Remove( proxy_id );
+
+    return true;
+}
+
+FAPPooledActorRef FActorPoolInstances::GetActorRef( const AActor * actor ) const
+{
+    const auto slot_index = FindSlotIndex( actor );
+
+    if ( slot_index == INDEX_NONE )
+    {
+        return FAPPooledActorRef();
+    }
+
+    const auto & slot = Slots.GetSlot( slot_index );
+
+    if ( slot.State != EAPPoolSlotState::Acquired )
+    {
+        return FAPPooledActorRef();
+    }
+
+    return FAPPooledActorRef( PoolId, slot_index, slot.Generation );
+}
+
+void FActorPoolInstances::DestroyActors()
+{
+    DissolveIdleInstancesCluster();
+
+    for ( auto * instance : Instances )
+    {
+        if ( IsValid( instance ) )
+        {
+            instance->Destroy();
+        }
+    }
+
+    Instances.Reset();
+    SlotIndices.Reset();
+    Slots.Reset();
+
+    if ( IsValid( ProxyComponent ) )
+    {
+        ProxyComponent->DestroyComponent();
+    }
+
+    ProxyComponent = nullptr;
+    ProxyIdByRow.Reset();
+    RowByProxyId.Reset();
+}
+
+void FActorPoolInstances::DestroyUnusedInstances()
+{
+    DestroyIdleInstances( Slots.GetAvailableSlotCount() );
+}
+
+bool FActorPoolInstances::UpdateTargetCount()
+{
+    // The server and the clients must keep the same number of instances to match the replicated instances
+    if ( PoolInfos.bMatchReplicatedInstancesOnClients )
+    {
+        return false;
+    }
+
+    const auto target_count = PoolInfos.GetScaledCount();
+
+    if ( target_count != TargetCount )
+    {
+        TargetCount = target_count;
+        bIsResizing = true;
+    }
+
+    return bIsResizing;
+}
+
+int FActorPoolInstances::ResizeTowardsTargetCount( UWorld * world, int max_count )
+{
+    const auto instance_count = GetInstanceCount();
+    const auto required_count = GetRequiredCount();
+    auto resized_count = 0;
+
+    if ( instance_count < required_count )
+    {
+        const auto spawn_count = FMath::Min( max_count, required_count - instance_count );
+
+        for ( ; resized_count < spawn_count; ++resized_count )
+        {
+            auto * actor = SpawnActorAndAddToInstances( world );
+
+            if ( actor == nullptr )
+            {
+                break;
+            }
+
+            DisableActor( actor );
+        }
+
+        if ( resized_count > 0 )
+        {
+            DissolveIdleInstancesCluster();
+        }
+    }
+    else if ( instance_count > required_count )
+    {
+        // Only the idle instances are destroyed. The acquired instances in excess stay in the pool
+        resized_count = DestroyIdleInstances( FMath::Min( max_count, instance_count - required_count ) );
+    }
+
+    bIsResizing = resized_count > 0 && GetInstanceCount() != required_count;
+    bIsShrinkPending = !bIsResizing && GetInstanceCount() > required_count;
+
+    return resized_count;
+}
+
+void FActorPoolInstances::StopResizing()
+{
+    bIsResizing = false;
+    bIsShrinkPending = false;
+}
+
+int FActorPoolInstances::AddReservation( int count, double deadline )
+{
+    const auto reservation_id = NextReservationId++;
+
+    Reservations.Add( reservation_id, { count, deadline } );
+    ReservedCount += count;
+
+    // A reservation never shrinks a pool which already grew on demand
+    bIsResizing |= GetInstanceCount() < GetRequiredCount();
+
+    UE_LOG( LogActorPool, Verbose, TEXT( "AddReservation : %s - Reservation : %i - Reserved Count : %i" ), *PoolInfos.ActorClass.ToString(), reservation_id, ReservedCount );
+
+    return reservation_id;
+}
+
+bool FActorPoolInstances::RemoveReservation( int reservation_id )
+{
+    Reservation reservation;
+
+    if ( !Reservations.RemoveAndCopyValue( reservation_id, reservation ) )
+    {
+        return false;
+    }
+
+    ReservedCount -= reservation.Count;
+    bIsResizing = GetInstanceCount() != GetRequiredCount();
+
+    UE_LOG( LogActorPool, Verbose, TEXT( "RemoveReservation : %s - Reservation : %i - Reserved Count : %i" ), *PoolInfos.ActorClass.ToString(), reservation_id, ReservedCount );
+
+    return true;
+}
+
+bool FActorPoolInstances::IsReservationDeadlineReached( double now ) const
+{
+    if ( !bIsResizing || GetInstanceCount() >= GetRequiredCount() )
+    {
+        return false;
+    }
+
+    for ( const auto & key_pair : Reservations )
+    {
+        if ( key_pair.Value.Deadline <= now )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int FActorPoolInstances::DestroyIdleInstances( int count )
+{
+    const auto destroyed_count = FMath::Min( count, GetIdleInstanceCount() );
+
+    if ( destroyed_count > 0 )
+    {
+        DissolveIdleInstancesCluster();
+    }
+
+    for ( auto index = 0; index < destroyed_count; ++index )
+    {
+        const auto slot_index = Slots.GetLastAvailableSlotIndex();
+
+        if ( auto * instance = Instances[ slot_index ] )
+        {
+            instance->Destroy();
+        }
+
+        RemoveSlotInstance( slot_index );
+    }
+
+    return destroyed_count;
+}
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+void FActorPoolInstances::ReportHeldInstances( double now )
+{
+    if ( PoolInfos.MaxHeldDuration <= 0.0f )
+    {
+        return;
+    }
+
+    for ( const auto slot_index : Slots.ReportSlotsHeldLongerThan( now, PoolInfos.MaxHeldDuration ) )
+    {
+        const auto & slot = Slots.GetSlot( slot_index );
+        UE_LOG( LogActorPool, Warning, TEXT( "%s has been held for %.1f seconds, more than the %.1f seconds allowed by its pool - Caller : %s" ), *GetNameSafe( Instances[ slot_index ] ), now - slot.AcquireTime, PoolInfos.MaxHeldDuration, *slot.CallerTag.ToString() );
+    }
+}
+
+void FActorPoolInstances::DumpHeldInstancesAges( FOutputDevice & output_device, double now ) const
+{
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "Pool for class %s - Acquired Instance Count : %i" ), *PoolInfos.ActorClass.ToString(), Slots.GetAcquiredSlotCount() );
+    Slots.DumpAcquiredSlotsAges( output_device, now );
+}
+#endif
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+void FActorPoolInstances::DumpPoolInfos( FOutputDevice & output_device ) const
+{
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "Pool for class %s" ), *PoolInfos.ActorClass.ToString() );
+    Slots.DumpSlotCounts( output_device );
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Target Instance Count : %i" ), TargetCount );
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Reserved Instance Count : %i" ), ReservedCount );
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Estimated Memory : %.1f KB (%.1f KB per instance)" ), GetMemorySize() / 1024.0, InstanceMemorySize / 1024.0 );
+
+    if ( ProxyComponent != nullptr )
+    {
+        output_device.Logf( ELogVerbosity::Verbose, TEXT( "   Proxy Count : %i" ), GetProxyCount() );
+    }
+}
+#endif
+
+void FActorPoolInstances::DisableActor( AActor * actor ) const
+{
+    actor->SetActorHiddenInGame( true );
+    actor->SetActorEnableCollision( false );
+    QueueNetDormancy( actor, ENetDormancy::DORM_DormantAll );
+
+    if ( PoolInfos.PhysicsParkingMode != EAPPhysicsParkingMode::None || PoolInfos.bIsolateIdleInstances )
+    {
+        ParkComponents( actor );
+    }
+
+    if ( Cast< IAPPooledActorInterface >( actor ) )
+    {
+        IAPPooledActorInterface::Execute_OnReturnedToPool( actor );
+    }
+}
+
+void FActorPoolInstances::DisableReturnedActor( AActor * actor, int slot_index )
+{
+    if ( ArchetypeSnapshot.IsValid() )
+    {
+        ArchetypeSnapshot.RestoreArchetypeValues( actor );
+    }
+
+    DisableActor( actor );
+    SetNetAcquired( actor, false );
+
+    // The slots keep their index for their whole lifetime, so each instance gets its own parking cell
+    if ( PoolInfos.bUseParkingLocation )
+    {
+        actor->SetActorLocationAndRotation( GetParkingLocation( slot_index ), PoolInfos.ParkingTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics );
+    }
+}
+
+void FActorPoolInstances::QueueNetDormancy( AActor * actor, const ENetDormancy net_dormancy, const bool force_net_update ) const
+{
+    if ( PoolInfos.bNeverReplicate )
+    {
+        return;
+    }
+
+    if ( auto * actor_pool_system = actor->GetWorld()->GetSubsystem< UActorPoolSubSystem >() )
+    {
+        actor_pool_system->QueueNetDormancy( actor, net_dormancy, force_net_update );
+    }
+}
+
+void FActorPoolInstances::QueueForceNetUpdate( AActor * actor ) const
+{
+    if ( PoolInfos.bNeverReplicate )
+    {
+        return;
+    }
+
+    if ( auto * actor_pool_system = actor->GetWorld()->GetSubsystem< UActorPoolSubSystem >() )
+    {
+        actor_pool_system->QueueForceNetUpdate( actor );
+    }
+}
+
+void FActorPoolInstances::ParkComponents( AActor * actor ) const
+{
+    TInlineComponentArray< UPrimitiveComponent * > primitive_components( actor );
+
+    for ( auto * primitive_component : primitive_components )
+    {
+        if ( PoolInfos.bIsolateIdleInstances )
+        {
+            primitive_component->SetGenerateOverlapEvents( false );
+
+            if ( primitive_component->CanEverAffectNavigation() )
+            {
+                primitive_component->SetCanEverAffectNavigation( false );
+            }
+        }
+
+        if ( PoolInfos.PhysicsParkingMode == EAPPhysicsParkingMode::None || !primitive_component->IsSimulatingPhysics() )
+        {
+            continue;
+        }
+
+        primitive_component->SetAllPhysicsLinearVelocity( FVector::ZeroVector );
+        primitive_component->SetAllPhysicsAngularVelocityInDegrees( FVector::ZeroVector );
+
+        switch ( PoolInfos.PhysicsParkingMode )
+        {
+            case EAPPhysicsParkingMode::Sleep:
+            {
+                primitive_component->PutAllRigidBodiesToSleep();
+            }
+            break;
+            case EAPPhysicsParkingMode::DisableSimulation:
+            {
+                primitive_component->SetSimulatePhysics( false );
+            }
+            break;
+            default:
+            {
+                checkNoEntry();
+            }
+            break;
+        }
+    }
+}
+
+void FActorPoolInstances::UnparkComponents( AActor * actor ) const
+{
+    TInlineComponentArray< UPrimitiveComponent * > primitive_components( actor );
+
+    for ( auto * primitive_component : primitive_components )
+    {
+        // What has been changed when parking the actor is restored from the archetype of the component
+        const auto * archetype = Cast< UPrimitiveComponent >( primitive_component->GetArchetype() );
+
+        if ( PoolInfos.bIsolateIdleInstances && archetype != nullptr )
+        {
+            primitive_component->SetGenerateOverlapEvents( archetype->GetGenerateOverlapEvents() );
+
+            if ( archetype->CanEverAffectNavigation() )
+            {
+                primitive_component->SetCanEverAffectNavigation( true );
+            }
+        }
+
+        if ( PoolInfos.PhysicsParkingMode == EAPPhysicsParkingMode::DisableSimulation && archetype != nullptr && archetype->BodyInstance.bSimulatePhysics )
+        {
+            primitive_component->SetSimulatePhysics( true );
+        }
+
+        if ( PoolInfos.PhysicsParkingMode != EAPPhysicsParkingMode::None && primitive_component->IsSimulatingPhysics() )
+        {
+            primitive_component->WakeAllRigidBodies();
+        }
+    }
+}
+
+FVector FActorPoolInstances::GetParkingLocation( const FActorPoolInfos & pool_infos, int slot_index )
+{
+    const auto & extent = pool_infos.ParkingExtent;
+    const auto & spacing = pool_infos.ParkingSpacing;
+
+    const auto get_cell_count = []( const auto axis_extent, const auto axis_spacing ) {
+        return axis_spacing > 0.0f ? FMath::Max( 1, FMath::FloorToInt( 2 * axis_extent / axis_spacing ) + 1 ) : 1;
+    };
+
+    const auto cell_count_x = get_cell_count( extent.X, spacing.X );
+    const auto cell_count_y = get_cell_count( extent.Y, spacing.Y );
+    const auto cell_count_z = get_cell_count( extent.Z, spacing.Z );
+    const auto cell_index = slot_index % ( cell_count_x * cell_count_y * cell_count_z );
+
+    const FVector cell_coordinates(
+        cell_index % cell_count_x,
+        ( cell_index / cell_count_x ) % cell_count_y,
+        cell_index / ( cell_count_x * cell_count_y ) );
+
+    return pool_infos.ParkingTransform.TransformPosition( -extent + cell_coordinates * spacing );
+}
+
+FVector FActorPoolInstances::GetParkingLocation( int slot_index ) const
+{
+    return GetParkingLocation( PoolInfos, slot_index );
+}
+
+void FActorPoolInstances::AdoptInstance( AActor * actor )
+{
+    // The adopted instances have been baked in a level or come from the pool of the world the game traveled from
+    const auto slot_index = Slots.AddSlot();
+
+    SetSlotInstance( slot_index, actor );
+
+    if ( PoolInfos.bUseParkingLocation )
+    {
+        actor->SetActorLocationAndRotation( GetParkingLocation( slot_index ), PoolInfos.ParkingTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics );
+    }
+
+    StripComponents( actor );
+    DisableActor( actor );
+
+    if ( InstanceMemorySize == 0 )
+    {
+        InstanceMemorySize = MeasureInstanceMemorySize( actor );
+    }
+}
+
+AActor * FActorPoolInstances::SpawnActorAndAddToInstances( UWorld * world, int prewarm_index )
+{
+    auto * actor_class = PoolInfos.ActorClass.LoadSynchronous();
+
+    FActorSpawnParameters spawn_parameters;
+    spawn_parameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    // The replication settings must be applied before the actor is finished, so it is registered with them
+    spawn_parameters.bDeferConstruction = true;
+
+    // The server and the clients give the same names to the instances they prewarm, so that when the server replicates one of them,
+    // the client resolves it by name to its own instance instead of spawning a new actor
+    const auto is_net_addressable = PoolInfos.bMatchReplicatedInstancesOnClients
+                                    && prewarm_index != INDEX_NONE
+                                    && world->GetNetMode() != NM_Standalone
+                                    && actor_class->GetDefaultObject< AActor >()->GetIsReplicated();
+
+    if ( is_net_addressable )
+    {
+        spawn_parameters.Name = FName( *FString::Printf( TEXT( "%s_Pooled_%i" ), *actor_class->GetName(), prewarm_index ) );
+        spawn_parameters.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Required_ErrorAndReturnNull;
+    }
+
+    const auto slot_index = Slots.AddSlot();
+
+    FTransform spawn_transform;
+
+    if ( PoolInfos.bUseParkingLocation )
+    {
+        spawn_transform.SetLocation( GetParkingLocation( slot_index ) );
+        spawn_transform.SetRotation( PoolInfos.ParkingTransform.GetRotation() );
+    }
+
+    auto * actor = world->SpawnActor< AActor >( actor_class, spawn_transform, spawn_parameters );
+
+    if ( actor == nullptr )
+    {
+        Slots.RemoveSlot( slot_index );
+        return nullptr;
+    }
+
+    // Keeps the instances out of the network object list, so the replication driver never considers them
+    if ( PoolInfos.bNeverReplicate )
+    {
+        actor->SetReplicates( false );
+    }
+
+    if ( is_net_addressable )
+    {
+        actor->SetNetAddressable();
+
+        // Like the actors loaded with the level, the local instances are owned by the server on clients
+        if ( world->GetNetMode() == NM_Client )
+        {
+            actor->ExchangeNetRoles( true );
+        }
+
+        // Created with the same name on both sides, so the client resolves the replicated component to its own
+        auto * net_component = NewObject< UAPPooledActorNetComponent >( actor, TEXT( "APPooledActorNet" ) );
+        net_component->SetNetAddressable();
+        actor->AddInstanceComponent( net_component );
+    }
+
+    actor->FinishSpawning( spawn_transform );
+
+    if ( !IsValid( actor ) )
+    {
+        Slots.RemoveSlot( slot_index );
+        return nullptr;
+    }
+
+    SetSlotInstance( slot_index, actor );
+
+    StripComponents( actor );
+
+    // All the instances of a pool share the same class, so measuring the first one is enough to estimate the memory used by the pool
+    if ( InstanceMemorySize == 0 )
+    {
+        InstanceMemorySize = MeasureInstanceMemorySize( actor );
+    }
+
+    return actor;
+}
+
+void FActorPoolInstances::SetSlotInstance( const int slot_index, AActor * actor )
+{
+    if ( slot_index >= Instances.Num() )
+    {
+        Instances.SetNum( slot_index + 1 );
+    }
+
+    Instances[ slot_index ] = actor;
+    SlotIndices.Add( actor, slot_index );
+}
+
+void FActorPoolInstances::RemoveSlotInstance( const int slot_index )
+{
+    if ( auto * instance = Instances[ slot_index ] )
+    {
+        SlotIndices.Remove( instance );
+    }
+    else
+    {
+        // The instance has been collected, so its key can only be found through its slot
+        for ( auto iterator = SlotIndices.CreateIterator(); iterator; ++iterator )
+        {
+            if ( iterator.Value() == slot_index )
+            {
+                iterator.RemoveCurrent();
+                break;
+            }
+        }
+    }
+
+    Instances[ slot_index ] = nullptr;
+    Slots.RemoveSlot( slot_index );
+}
+
+int FActorPoolInstances::FindSlotIndex( const AActor * actor ) const
+{
+    const auto * slot_index = SlotIndices.Find( actor );
+    return slot_index != nullptr ? *slot_index : INDEX_NONE;
+}
+
+void FActorPoolInstances::StripComponents( AActor * actor ) const
+{
+    if ( StrippedComponentClasses.Num() == 0 )
+    {
+        return;
+    }
+
+    TInlineComponentArray< UActorComponent * > components( actor );
+    auto stripped_component_count = 0;
+
+    for ( auto * component : components )
+    {
+        if ( component == actor->GetRootComponent() )
+        {
+            continue;
+        }
+
+        for ( const auto * component_class : StrippedComponentClasses )
+        {
+            if ( component->IsA( component_class ) )
+            {
+                // The children are attached to the parent of the destroyed component, so the hierarchy stays valid
+                component->DestroyComponent( true );
+                stripped_component_count++;
+                break;
+            }
+        }
+    }
+
+    UE_LOG( LogActorPool, Verbose, TEXT( "StripComponents : %s - Stripped Component Count : %i" ), *GetNameSafe( actor ), stripped_component_count );
+}
+
+int64 FActorPoolInstances::MeasureInstanceMemorySize( const AActor * actor )
+{
+    const auto get_object_size = []( const UObject * object ) {
+        return static_cast< int64 >( object->GetClass()->GetStructureSize() ) + object->GetResourceSizeBytes( EResourceSizeMode::Exclusive );
+    };
+
+    auto memory_size = get_object_size( actor );
+
+    TInlineComponentArray< UActorComponent * > components( actor );
+
+    for ( const auto * component : components )
+    {
+        memory_size += get_object_size( component );
+    }
+
+    return memory_size;
+}
+
+AActorPoolActor::AActorPoolActor() :
+    NextPoolSerial( 0 )
+{
+    // Only ticks while there are deferred returns to process or pools to resize.
+    // Ticks during the pause too, so the actors returned right before it are not left acquired until the game resumes
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = false;
+    PrimaryActorTick.bTickEvenWhenPaused = true;
+}
+
+void AActorPoolActor::BeginPlay()
+{
+    Super::BeginPlay();
+
+    SetTickGroup( GetDefault< UActorPoolSettings >()->DeferredReturnTickGroup );
+
+    // Initialize the pools
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+    if ( GActorPoolDisable.GetValueOnGameThread() == 0 )
+#endif
+    {
+        if ( auto * settings = GetDefault< UActorPoolSettings >() )
+        {
+            for ( const auto & pool_infos : settings->PoolInfos )
+            {
+                RegisterPooledActor( pool_infos );
+            }
+
+            for ( const auto & object_pool_infos : settings->ObjectPoolInfos )
+            {
+                AddObjectPool( object_pool_infos );
+            }
+        }
+    }
+
+    UpdateIdleInstancesClustersTimer();
+
+    FWorldDelegates::LevelAddedToWorld.AddUObject( this, &ThisClass::OnLevelAddedToWorld );
+    FWorldDelegates::LevelRemovedFromWorld.AddUObject( this, &ThisClass::OnLevelRemovedFromWorld );
+
+    // The scalability groups and the device profiles change the pool sizes through console variables
+    ConsoleVariableSinkHandle = IConsoleManager::Get().RegisterConsoleVariableSink_Handle( FConsoleCommandDelegate::CreateUObject( this, &ThisClass::OnConsoleVariablesChanged ) );
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+    const auto held_instances_scan_interval = GActorPoolHeldInstancesScanInterval.GetValueOnGameThread();
+    if ( held_instances_scan_interval > 0.0f )
+    {
+        GetWorldTimerManager().SetTimer( HeldInstancesScanTimerHandle, this, &ThisClass::ReportHeldInstances, held_instances_scan_interval, true );
+    }
+#endif
+
+    // Register itself to the subsystem
+    if ( auto * actor_pool_system = GetWorld()->GetSubsystem< UActorPoolSubSystem >() )
+    {
+        actor_pool_system->RegisterActorPoolActor( this );
+    }
+
+    // The pools registered once the actor pool is ready, or once their level is streamed in, must get a chance to adopt their traveling instances first
+    const auto unclaimed_traveling_instances_lifetime = GActorPoolUnclaimedTravelingInstancesLifetime.GetValueOnGameThread();
+    if ( unclaimed_traveling_instances_lifetime > 0.0f )
+    {
+        GetWorldTimerManager().SetTimer( UnclaimedTravelingInstancesTimerHandle, this, &ThisClass::DestroyUnclaimedTravelingInstances, unclaimed_traveling_instances_lifetime, false );
+    }
+    else
+    {
+        UnclaimedTravelingInstancesTimerHandle = GetWorldTimerManager().SetTimerForNextTick( this, &ThisClass::DestroyUnclaimedTravelingInstances );
+    }
+}
+
+void AActorPoolActor::EndPlay( const EEndPlayReason::Type end_play_reason )
+{
+    FWorldDelegates::LevelAddedToWorld.RemoveAll( this );
+    FWorldDelegates::LevelRemovedFromWorld.RemoveAll( this );
+    IConsoleManager::Get().UnregisterConsoleVariableSink_Handle( ConsoleVariableSinkHandle );
+
+    for ( auto & level_scoped_pool : LevelScopedPools )
+    {
+        GetWorldTimerManager().ClearTimer( level_scoped_pool.DestroyTimerHandle );
+    }
+
+    LevelScopedPools.Reset();
+    DeferredReturns.Reset();
+    RetiredInstances.Reset();
+    SkippedPoolClasses.Reset();
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+    GetWorldTimerManager().ClearTimer( HeldInstancesScanTimerHandle );
+#endif
+
+    GetWorldTimerManager().ClearTimer( IdleInstancesClustersTimerHandle );
+    GetWorldTimerManager().ClearTimer( UnclaimedTravelingInstancesTimerHandle );
+
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        ActorPools[ key_pair.Value ].DestroyActors();
+    }
+
+    for ( auto & key_pair : ObjectPools )
+    {
+        key_pair.Value.DestroyObjects();
+    }
+
+    Super::EndPlay( end_play_reason );
+}
+
+void AActorPoolActor::Tick( float delta_seconds )
+{
+    Super::Tick( delta_seconds );
+
+    ProcessDeferredReturns();
+    ResizePools();
+
+    SetActorTickEnabled( DeferredReturns.Num() > 0 || IsResizingPools() );
+}
+
+bool AActorPoolActor::IsActorClassPoolable( TSubclassOf< AActor > actor_class ) const
+{
+    if ( actor_class == nullptr )
+    {
+        return false;
+    }
+
+    return ActorPoolIndices.Contains( actor_class );
+}
+
+int AActorPoolActor::GetIdleInstanceCount( TSubclassOf< AActor > actor_class ) const
+{
+    const auto * actor_instances = FindActorPool( actor_class );
+    return actor_instances != nullptr ? actor_instances->GetIdleInstanceCount() : 0;
+}
+
+int AActorPoolActor::GetInstanceCount( TSubclassOf< AActor > actor_class ) const
+{
+    const auto * actor_instances = FindActorPool( actor_class );
+    return actor_instances != nullptr ? actor_instances->GetInstanceCount() : 0;
+}
+
+bool AActorPoolActor::IsPoolDrivenByServer( TSubclassOf< AActor > actor_class ) const
+{
+    const auto * actor_instances = FindActorPool( actor_class );
+    return actor_instances != nullptr && actor_instances->IsDrivenByServer();
+}
+
+void AActorPoolActor::RegisterPooledActor( const FActorPoolInfos & actor_pool_infos )
+{
+    if ( !ensureAlways( actor_pool_infos.ActorClass != nullptr ) )
+    {
+        return;
+    }
+
+    if ( actor_pool_infos.StreamingLevel.IsNull() )
+    {
+        AddActorPool( actor_pool_infos );
+        return;
+    }
+
+    // Several game feature actions can register the same pool
+    const auto is_registered = LevelScopedPools.ContainsByPredicate( [ & ]( const LevelScopedPool & level_scoped_pool ) {
+        return level_scoped_pool.PoolInfos.ActorClass == actor_pool_infos.ActorClass;
+    } );
+
+    if ( is_registered )
+    {
+        UE_LOG( LogActorPool, Verbose, TEXT( "RegisterPooledActor : The level scoped pool of %s is already registered" ), *actor_pool_infos.ActorClass.ToString() );
+        return;
+    }
+
+    // Level scoped pools are only created while their level is in the world
+    auto & level_scoped_pool = LevelScopedPools.Emplace_GetRef( actor_pool_infos );
+
+    for ( const auto * level : GetWorld()->GetLevels() )
+    {
+        if ( level_scoped_pool.IsForLevel( level ) )
+        {
+            AddActorPool( actor_pool_infos );
+            break;
+        }
+    }
+}
+
+void AActorPoolActor::UnRegisterPooledActor( const FActorPoolInfos & actor_pool_infos )
+{
+    if ( actor_pool_infos.ActorClass == nullptr )
+    {
+        return;
+    }
+
+    const auto level_scoped_pool_index = LevelScopedPools.IndexOfByPredicate( [ & ]( const LevelScopedPool & level_scoped_pool ) {
+        return level_scoped_pool.PoolInfos.ActorClass == actor_pool_infos.ActorClass;
+    } );
+
+    if ( level_scoped_pool_index != INDEX_NONE )
+    {
+        GetWorldTimerManager().ClearTimer( LevelScopedPools[ level_scoped_pool_index ].DestroyTimerHandle );
+        LevelScopedPools.RemoveAt( level_scoped_pool_index );
+    }
+
+    RemoveActorPool( actor_pool_infos );
+}
+
+void AActorPoolActor::AddActorPool( const FActorPoolInfos & actor_pool_infos, bool is_prewarm_deferred )
+{
+    auto * actor_class = actor_pool_infos.ActorClass.LoadSynchronous();
+
+    if ( !ensureAlways( FindActorPool( actor_class ) == nullptr ) )
+    {
+        return;
+    }
+
+    if ( CanCreatePool( actor_pool_infos.bSpawnOnServer, actor_pool_infos.bSpawnOnClients ) )
+    {
+        const auto & actor_instances = AddActorPoolInstance( actor_class, actor_pool_infos, is_prewarm_deferred );
+
+        if ( actor_instances.IsResizing() )
+        {
+            SetActorTickEnabled( true );
+        }
+
+        UpdateIdleInstancesClustersTimer();
+        EnforceMemoryBudget();
+    }
+    else
+    {
+        // No pool adopts them on this side of the network, so they would stay hidden forever
+        SkippedPoolClasses.Add( actor_class );
+        DestroyBakedInstances( actor_class );
+    }
+}
+
+void AActorPoolActor::RemoveActorPool( const FActorPoolInfos & actor_pool_infos )
+{
+    auto * actor_class = actor_pool_infos.ActorClass.LoadSynchronous();
+    auto * existing_actor_pool = FindActorPool( actor_class );
+
+    if ( existing_actor_pool == nullptr )
+    {
+        return;
+    }
+
+    if ( CanCreatePool( actor_pool_infos.bSpawnOnServer, actor_pool_infos.bSpawnOnClients ) )
+    {
+        // The acquired instances are still used by the gameplay code, so they are only destroyed when they are returned
+        TArray< AActor * > acquired_instances;
+        existing_actor_pool->ReleaseAcquiredInstances( acquired_instances );
+
+        for ( auto * instance : acquired_instances )
+        {
+            RetiredInstances.Add( instance );
+        }
+
+        existing_actor_pool->DestroyActors();
+        RemoveActorPoolInstance( actor_class );
+        UpdateIdleInstancesClustersTimer();
+    }
+    else
+    {
+        SkippedPoolClasses.Remove( actor_class );
+    }
+}
+
+void AActorPoolActor::AddObjectPool( const FAPObjectPoolInfos & object_pool_infos )
+{
+    auto * object_class = object_pool_infos.ObjectClass.LoadSynchronous();
+
+    if ( !ensureAlways( object_class != nullptr && ObjectPools.Find( object_class ) == nullptr ) )
+    {
+        return;
+    }
+
+    if ( CanCreatePool( object_pool_infos.bSpawnOnServer, object_pool_infos.bSpawnOnClients ) )
+    {
+        ObjectPools.Emplace( object_class, FAPObjectPoolInstances( this, object_pool_infos ) );
+    }
+}
+
+bool AActorPoolActor::CanCreatePool( bool spawn_on_server, bool spawn_on_clients ) const
+{
+    const auto * world = GetWorld();
+    const auto is_standalone = UKismetSystemLibrary::IsStandalone( world );
+    auto is_server = IsRunningDedicatedServer();
+
+#if WITH_EDITOR
+    checkSlow( game_instance->GetWorldContext() );
+    is_server |= world->GetGameInstance()->GetWorldContext()->RunAsDedicated;
+#endif
+
+    const auto is_client = !is_server;
+
+    return is_standalone || is_server && spawn_on_server || is_client && spawn_on_clients;
+}
+
+AActor * AActorPoolActor::GetActorFromPool( TSubclassOf< AActor > actor_class, const FTransform & transform, FName caller_tag, const FInstancedStruct * payload )
+{
+    auto * actor_instances = FindActorPool( actor_class );
+
+    if ( actor_instances != nullptr && actor_instances->IsDrivenByServer() )
+    {
+        UE_LOG( LogActorPool, Warning, TEXT( "GetActorFromPool : The instances of %s are acquired and returned by the server on clients." ), *GetNameSafe( actor_class ) );
+        return nullptr;
+    }
+
+    if ( actor_instances == nullptr )
+    {
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+        if ( FAPPoolSlots::IsInstanceCreationForced() )
+        {
+            FActorPoolInfos pool_infos;
+            pool_infos.ActorClass = actor_class;
+            pool_infos.Count = 1;
+            pool_infos.PoolingPolicy = EAPPoolingPolicy::CreateNewInstances;
+
+            actor_instances = &AddActorPoolInstance( actor_class, pool_infos );
+        }
+        else
+#endif
+        {
+            return nullptr;
+        }
+    }
+
+    const auto instance_count = actor_instances->GetInstanceCount();
+    auto * actor = actor_instances->GetAvailableInstance( GetWorld(), transform, caller_tag, payload );
+
+    if ( actor_instances->GetInstanceCount() > instance_count )
+    {
+        EnforceMemoryBudget();
+    }
+
+    return actor;
+}
+
+bool AActorPoolActor::ReturnActorToPool( AActor * actor, FName caller_tag )
+{
+    if ( actor == nullptr )
+    {
+        return false;
+    }
+
+    if ( DestroyRetiredInstance( actor ) )
+    {
+        return true;
+    }
+
+    if ( auto * actor_instances = FindActorPool( actor->GetClass() ) )
+    {
+        if ( !actor_instances->ReturnActor( actor, caller_tag ) )
+        {
+            return false;
+        }
+
+        // The return can resume the shrink of the pool
+        if ( actor_instances->IsResizing() )
+        {
+            SetActorTickEnabled( true );
+        }
+
+        return true;
+    }
+
+    UE_LOG( LogActorPool, Warning, TEXT( "ReturnActorToPool : There is no pool for the class of %s - Caller : %s" ), *GetNameSafe( actor ), *caller_tag.ToString() );
+
+    return false;
+}
+
+void AActorPoolActor::MirrorServerInstance( AActor * actor, const bool is_acquired )
+{
+    if ( actor == nullptr )
+    {
+        return;
+    }
+
+    auto * actor_instances = FindActorPool( actor->GetClass() );
+
+    if ( actor_instances != nullptr && actor_instances->IsDrivenByServer() )
+    {
+        actor_instances->MirrorServerInstance( actor, is_acquired );
+    }
+}
+
+bool AActorPoolActor::ReturnActorToPoolDeferred( AActor * actor, FName caller_tag )
+{
+    if ( actor == nullptr )
+    {
+        return false;
+    }
+
+    // The retired instances have no pool anymore, and are destroyed when the queue is processed
+    if ( RetiredInstances.Contains( actor ) )
+    {
+        DeferredReturns.Add( { FAPPooledActorRef(), actor, caller_tag } );
+        SetActorTickEnabled( true );
+        return true;
+    }
+
+    const auto * actor_instances = FindActorPool( actor->GetClass() );
+
+    if ( actor_instances == nullptr )
+    {
+        UE_LOG( LogActorPool, Warning, TEXT( "ReturnActorToPoolDeferred : There is no pool for the class of %s - Caller : %s" ), *GetNameSafe( actor ), *caller_tag.ToString() );
+        return false;
+    }
+
+    // The reference stops resolving once the actor is returned, so a queued return can't release the next acquisition of the same instance
+    const auto actor_ref = actor_instances->GetActorRef( actor );
+
+    if ( !actor_ref.IsValid() )
+    {
+        UE_LOG( LogActorPool, Warning, TEXT( "ReturnActorToPoolDeferred : %s is not acquired from its pool - Caller : %s" ), *GetNameSafe( actor ), *caller_tag.ToString() );
+        return false;
+    }
+
+    DeferredReturns.Add( { actor_ref, actor, caller_tag } );
+    SetActorTickEnabled( true );
+
+    return true;
+}
+
+FAPPooledProxyHandle AActorPoolActor::AcquireProxy( TSubclassOf< AActor > actor_class, const FTransform & transform )
+{
+    auto * actor_instances = FindActorPool( actor_class );
+
+    if ( actor_instances == nullptr )
+    {
+        return FAPPooledProxyHandle();
+    }
+
+    const auto proxy_id = actor_instances->AcquireProxy( transform );
+    return proxy_id != INDEX_NONE ? FAPPooledProxyHandle( actor_instances->GetPoolId(), proxy_id ) : FAPPooledProxyHandle();
+}
+
+FAPPoolReservationHandle AActorPoolActor::ReserveCapacity( TSubclassOf< AActor > actor_class, int count, float deadline )
+{
+    auto * actor_instances = FindActorPool( actor_class );
+
+    if ( actor_instances == nullptr || actor_instances->IsDrivenByServer() || count <= 0 )
+    {
+        return FAPPoolReservationHandle();
+    }
+
+    const auto reservation_id = actor_instances->AddReservation( count, FPlatformTime::Seconds() + deadline );
+
+    if ( actor_instances->IsResizing() )
+    {
+        SetActorTickEnabled( true );
+    }
+
+    return FAPPoolReservationHandle( actor_instances->GetPoolId(), reservation_id );
+}
+
+bool AActorPoolActor::ReleaseReservation( const FAPPoolReservationHandle & handle )
+{
+    auto * actor_instances = FindPoolById( handle.PoolId );
+
+    if ( actor_instances == nullptr )
+    {
+        return false;
+    }
+
+    if ( !actor_instances->RemoveReservation( handle.ReservationId ) )
+    {
+        return false;
+    }
+
+    if ( actor_instances->IsResizing() )
+    {
+        SetActorTickEnabled( true );
+    }
+
+    return true;
+}
+
+bool AActorPoolActor::ReturnProxy( const FAPPooledProxyHandle & handle )
+{
+    auto * actor_instances = FindPoolById( handle.PoolId );
+    return actor_instances != nullptr && actor_instances->ReturnProxy( handle.ProxyId );
+}
+
+AActor * AActorPoolActor::HydrateProxy( const FAPPooledProxyHandle & handle, FTransform & transform, FName caller_tag )
+{
+    auto * actor_instances = FindPoolById( handle.PoolId );
+
+    if ( actor_instances == nullptr || !actor_instances->GetProxyTransform( handle.ProxyId, transform ) )
+    {
+        return nullptr;
+    }
+
+    // Acquiring through GetActorFromPool refuses the pools driven by the server and applies the memory budget.
+    // The proxy stays in place if no actor can replace it
+    auto * actor = GetActorFromPool( actor_instances->GetPoolInfos().ActorClass.Get(), transform, caller_tag );
+
+    if ( actor != nullptr )
+    {
+        actor_instances->ReturnProxy( handle.ProxyId );
+    }
+
+    return actor;
+}
+
+FAPPooledProxyHandle AActorPoolActor::DehydrateActor( AActor * actor, FName caller_tag )
+{
+    if ( actor == nullptr )
+    {
+        return FAPPooledProxyHandle();
+    }
+
+    auto * actor_instances = FindActorPool( actor->GetClass() );
+
+    if ( actor_instances == nullptr )
+    {
+        return FAPPooledProxyHandle();
+    }
+
+    const auto proxy_id = actor_instances->DehydrateActor( actor, caller_tag );
+
+    if ( actor_instances->IsResizing() )
+    {
+        SetActorTickEnabled( true );
+    }
+    return proxy_id != INDEX_NONE ? FAPPooledProxyHandle( actor_instances->GetPoolId(), proxy_id ) : FAPPooledProxyHandle();
+}
+
+UObject * AActorPoolActor::GetObjectFromPool( TSubclassOf< UObject > object_class, FName caller_tag )
+{
+    if ( auto * object_instances = ObjectPools.Find( object_class ) )
+    {
+        return object_instances->GetAvailableInstance( nullptr, NAME_None, caller_tag );
+    }
+
+    return nullptr;
+}
+
+UActorComponent * AActorPoolActor::GetComponentFromPool( TSubclassOf< UActorComponent > component_class, USceneComponent * attach_parent, FName socket_name, FName caller_tag )
+{
+    if ( auto * object_instances = ObjectPools.Find( component_class ) )
+    {
+        return Cast< UActorComponent >( object_instances->GetAvailableInstance( attach_parent, socket_name, caller_tag ) );
+    }
+
+    return nullptr;
+}
+
+bool AActorPoolActor::ReturnObjectToPool( UObject * object, FName caller_tag )
+{
+    if ( object == nullptr )
+    {
+        return false;
+    }
+
+    if ( auto * object_instances = ObjectPools.Find( object->GetClass() ) )
+    {
+        return object_instances->ReturnObject( object, caller_tag );
+    }
+
+    UE_LOG( LogActorPool, Warning, TEXT( "ReturnObjectToPool : There is no pool for the class of %s - Caller : %s" ), *GetNameSafe( object ), *caller_tag.ToString() );
+
+    return false;
+}
+
+FAPPooledActorRef AActorPoolActor::GetPooledActorRef( const AActor * actor ) const
+{
+    if ( actor == nullptr )
+    {
+        return FAPPooledActorRef();
+    }
+
+    if ( const auto * actor_instances = FindActorPool( actor->GetClass() ) )
+    {
+        return actor_instances->GetActorRef( actor );
+    }
+
+    return FAPPooledActorRef();
+}
+
+AActor * AActorPoolActor::ResolvePooledActorRef( const FAPPooledActorRef & ref ) const
+{
+    const auto * actor_instances = FindPoolById( ref.PoolId );
+    return actor_instances != nullptr ? actor_instances->ResolveActorRef( ref ) : nullptr;
+}
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+void AActorPoolActor::DestroyUnusedInstancesInPools()
+{
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        ActorPools[ key_pair.Value ].DestroyUnusedInstances();
+    }
+
+    for ( auto & key_pair : ObjectPools )
+    {
+        key_pair.Value.DestroyUnusedInstances();
+    }
+}
+
+void AActorPoolActor::DumpHeldInstancesAges( FOutputDevice & output_device ) const
+{
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "Dumping the ages of the acquired instances :" ) );
+
+    const auto now = FPlatformTime::Seconds();
+
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        ActorPools[ key_pair.Value ].DumpHeldInstancesAges( output_device, now );
+    }
+
+    for ( const auto & key_pair : ObjectPools )
+    {
+        key_pair.Value.DumpHeldInstancesAges( output_device, now );
+    }
+}
+
+void AActorPoolActor::ReportHeldInstances()
+{
+    const auto now = FPlatformTime::Seconds();
+
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        ActorPools[ key_pair.Value ].ReportHeldInstances( now );
+    }
+
+    for ( auto & key_pair : ObjectPools )
+    {
+        key_pair.Value.ReportHeldInstances( now );
+    }
+}
+
+void AActorPoolActor::DumpPoolInfos( FOutputDevice & output_device ) const
+{
+    output_device.Logf( ELogVerbosity::Verbose, TEXT( "Dumping Actor Pool Infos :" ) );
+
+    const auto memory_budget = GetDefault< UActorPoolSettings >()->MemoryBudget;
+    if ( memory_budget > 0 )
+    {
+        output_device.Logf( ELogVerbosity::Verbose, TEXT( "Estimated Memory : %.1f KB / Budget : %.1f KB" ), GetMemorySize() / 1024.0, memory_budget / 1024.0 );
+    }
+    else
+    {
+        output_device.Logf( ELogVerbosity::Verbose, TEXT( "Estimated Memory : %.1f KB / No Budget" ), GetMemorySize() / 1024.0 );
+    }
+
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        ActorPools[ key_pair.Value ].DumpPoolInfos( output_device );
+    }
+
+    for ( auto & key_pair : ObjectPools )
+    {
+        key_pair.Value.DumpPoolInfos( output_device );
+    }
+}
+#endif
+
+void AActorPoolActor::OnLevelAddedToWorld( ULevel * level, UWorld * world )
+{
+    if ( world != GetWorld() )
+    {
+        return;
+    }
+
+    for ( auto & level_scoped_pool : LevelScopedPools )
+    {
+        if ( !level_scoped_pool.IsForLevel( level ) )
+        {
+            continue;
+        }
+
+        // The level came back before the pool was destroyed : keep the existing instances
+        if ( level_scoped_pool.DestroyTimerHandle.IsValid() )
+        {
+            GetWorldTimerManager().ClearTimer( level_scoped_pool.DestroyTimerHandle );
+            continue;
+        }
+
+        // Spawning all the instances in the frame the level is added would add to the hitch of the streaming
+        if ( !IsActorClassPoolable( level_scoped_pool.PoolInfos.ActorClass.LoadSynchronous() ) )
+        {
+            AddActorPool( level_scoped_pool.PoolInfos, true );
+        }
+    }
+
+    ClaimBakedInstances( level );
+}
+
+void AActorPoolActor::OnLevelRemovedFromWorld( ULevel * level, UWorld * world )
+{
+    if ( world != GetWorld() || level == nullptr )
+    {
+        return;
+    }
+
+    // The instances baked in the level are unloaded with it
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        auto & actor_instances = ActorPools[ key_pair.Value ];
+
+        if ( actor_instances.RemoveInstancesOfLevel( level ) > 0 && actor_instances.IsResizing() )
+        {
+            SetActorTickEnabled( true );
+        }
+    }
+
+    for ( auto & level_scoped_pool : LevelScopedPools )
+    {
+        if ( !level_scoped_pool.IsForLevel( level ) )
+        {
+            continue;
+        }
+
+        if ( level_scoped_pool.PoolInfos.StreamedOutPoolLifetime <= 0.0f )
+        {
+            RemoveActorPool( level_scoped_pool.PoolInfos );
+            continue;
+        }
+
+        GetWorldTimerManager().SetTimer(
+            level_scoped_pool.DestroyTimerHandle,
+            FTimerDelegate::CreateUObject( this, &ThisClass::OnLevelScopedPoolExpired, level_scoped_pool.PoolInfos.ActorClass ),
+            level_scoped_pool.PoolInfos.StreamedOutPoolLifetime,
+            false );
+    }
+}
+
+void AActorPoolActor::OnLevelScopedPoolExpired( TSoftClassPtr< AActor > actor_class )
+{
+    for ( auto & level_scoped_pool : LevelScopedPools )
+    {
+        if ( level_scoped_pool.PoolInfos.ActorClass == actor_class )
+        {
+            level_scoped_pool.DestroyTimerHandle.Invalidate();
+            RemoveActorPool( level_scoped_pool.PoolInfos );
+            return;
+        }
+    }
+}
+
+AActorPoolActor::LevelScopedPool::LevelScopedPool( const FActorPoolInfos & pool_infos ) :
+    PoolInfos( pool_infos ),
+    LevelPackageName( pool_infos.StreamingLevel.ToSoftObjectPath().GetLongPackageFName() )
+{
+}
+
+bool AActorPoolActor::LevelScopedPool::IsForLevel( const ULevel * level ) const
+{
+    if ( level == nullptr )
+    {
+        return false;
+    }
+
+    // Levels streamed in PIE have their package name prefixed
+    return FName( *UWorld::RemovePIEPrefix( level->GetOutermost()->GetName() ) ) == LevelPackageName;
+}
+
+bool AActorPoolActor::DestroyRetiredInstance( AActor * actor )
+{
+    if ( RetiredInstances.Num() == 0 || RetiredInstances.Remove( actor ) == 0 )
+    {
+        return false;
+    }
+
+    actor->Destroy();
+    return true;
+}
+
+int64 AActorPoolActor::GetMemorySize() const
+{
+    int64 memory_size = 0;
+
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        memory_size += ActorPools[ key_pair.Value ].GetMemorySize();
+    }
+
+    return memory_size;
+}
+
+void AActorPoolActor::EnforceMemoryBudget()
+{
+    const auto memory_budget = GetDefault< UActorPoolSettings >()->MemoryBudget;
+
+    if ( memory_budget <= 0 )
+    {
+        return;
+    }
+
+    auto exceeding_memory_size = GetMemorySize() - memory_budget;
+
+    if ( exceeding_memory_size <= 0 )
+    {
+        return;
+    }
+
+    TArray< FActorPoolInstances *, TInlineAllocator< 16 > > evictable_pools;
+
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        auto & actor_instances = ActorPools[ key_pair.Value ];
+
+        // The server and the clients must keep the same instances to match the replicated ones
+        if ( actor_instances.GetPoolInfos().bMatchReplicatedInstancesOnClients )
+        {
+            continue;
+        }
+
+        if ( actor_instances.GetEvictableInstanceCount() > 0 && actor_instances.GetInstanceMemorySize() > 0 )
+        {
+            evictable_pools.Add( &actor_instances );
+        }
+    }
+
+    // Evict from the pools with the lowest priority first, then from the least recently used ones
+    evictable_pools.Sort( []( const FActorPoolInstances & left, const FActorPoolInstances & right ) {
+        if ( left.GetPriority() != right.GetPriority() )
+        {
+            return left.GetPriority() < right.GetPriority();
+        }
+
+        return left.GetLastAcquireTime() < right.GetLastAcquireTime();
+    } );
+
+    for ( auto * pool : evictable_pools )
+    {
+        const auto instance_memory_size = pool->GetInstanceMemorySize();
+        const auto count_to_evict = static_cast< int >( FMath::DivideAndRoundUp( exceeding_memory_size, instance_memory_size ) );
+        const auto evicted_count = pool->DestroyIdleInstances( FMath::Min( count_to_evict, pool->GetEvictableInstanceCount() ) );
+
+        UE_LOG( LogActorPool, Verbose, TEXT( "EnforceMemoryBudget : Evicted %i instances from the pool of %s" ), evicted_count, *pool->GetPoolInfos().ActorClass.ToString() );
+
+        // Otherwise a pool whose target does not fit in the budget would spawn and evict its instances forever
+        if ( evicted_count > 0 && pool->IsResizing() )
+        {
+            pool->StopResizing();
+
+            UE_LOG( LogActorPool, Warning, TEXT( "EnforceMemoryBudget : The target count of the pool of %s does not fit in the memory budget. Stopped resizing it at %i instances" ), *pool->GetPoolInfos().ActorClass.ToString(), pool->GetInstanceCount() );
+        }
+
+        exceeding_memory_size -= evicted_count * instance_memory_size;
+
+        if ( exceeding_memory_size <= 0 )
+        {
+            return;
+        }
+    }
+
+    UE_LOG( LogActorPool, Warning, TEXT( "EnforceMemoryBudget : The pools still use %lld bytes more than the budget, but all the idle instances which are not reserved have been evicted." ), exceeding_memory_size );
+}
+
+void AActorPoolActor::ProcessDeferredReturns()
+{
+    // The returns can queue new deferred returns, which are processed during the next tick
+    auto deferred_returns = MoveTemp( DeferredReturns );
+    DeferredReturns.Reset();
+
+    deferred_returns.RemoveAllSwap( []( const DeferredReturn & deferred_return ) {
+        return !deferred_return.Actor.IsValid();
+    } );
+
+    // Sort by pool so each pool is looked up once
+    deferred_returns.Sort( []( const DeferredReturn & left, const DeferredReturn & right ) {
+        return left.Ref.PoolId < right.Ref.PoolId;
+    } );
+
+    FActorPoolInstances * actor_instances = nullptr;
+    auto actor_instances_id = INDEX_NONE;
+    TArray< FAPPooledActorRef > pool_refs;
+
+    // The actors of a pool are returned together, once the references of the whole run of that pool are gathered
+    const auto return_pool_refs = [ & ]() {
+        if ( actor_instances != nullptr && pool_refs.Num() > 0 )
+        {
+            actor_instances->ReturnInstances( pool_refs );
+        }
+
+        pool_refs.Reset();
+    };
+
+    for ( const auto & deferred_return : deferred_returns )
+    {
+        auto * actor = deferred_return.Actor.Get();
+
+        if ( DestroyRetiredInstance( actor ) )
+        {
+            continue;
+        }
+
+        if ( deferred_return.Ref.PoolId != actor_instances_id )
+        {
+            return_pool_refs();
+
+            actor_instances_id = deferred_return.Ref.PoolId;
+            actor_instances = FindPoolById( actor_instances_id );
+        }
+
+        // The reference does not resolve anymore once the actor has been returned, so an actor returned then acquired again by a new owner since it was queued
+        // is left to that owner. An actor queued several times in this batch is only returned once by ReturnInstances
+        if ( actor_instances == nullptr || actor_instances->ResolveActorRef( deferred_return.Ref ) != actor )
+        {
+            UE_LOG( LogActorPool, Verbose, TEXT( "ProcessDeferredReturns : Skipped the stale return of %s - Caller : %s" ), *GetNameSafe( actor ), *deferred_return.CallerTag.ToString() );
+            continue;
+        }
+
+        pool_refs.Add( deferred_return.Ref );
+    }
+
+    return_pool_refs();
+
+    UE_LOG( LogActorPool, Verbose, TEXT( "ProcessDeferredReturns : Processed %i deferred returns" ), deferred_returns.Num() );
+}
+
+void AActorPoolActor::OnConsoleVariablesChanged()
+{
+    auto is_resizing_pools = false;
+
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        is_resizing_pools |= ActorPools[ key_pair.Value ].UpdateTargetCount();
+    }
+
+    if ( is_resizing_pools )
+    {
+        SetActorTickEnabled( true );
+    }
+
+    UpdateIdleInstancesClustersTimer();
+}
+
+void AActorPoolActor::ResizePools()
+{
+    auto remaining_budget = GActorPoolResizeBudgetPerFrame.GetValueOnGameThread();
+    const auto memory_size = GetMemorySize();
+    const auto now = FPlatformTime::Seconds();
+
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        auto & actor_instances = ActorPools[ key_pair.Value ];
+
+        if ( !actor_instances.IsResizing() )
+        {
+            continue;
+        }
+
+        // The reservations past their deadline are fulfilled at once, regardless of the budget
+        if ( actor_instances.IsReservationDeadlineReached( now ) )
+        {
+            actor_instances.ResizeTowardsTargetCount( GetWorld(), MAX_int32 );
+
+            UE_LOG( LogActorPool, Verbose, TEXT( "ResizePools : %s - Reservation deadline reached - Instance Count : %i" ), *GetNameSafe( key_pair.Key ), actor_instances.GetInstanceCount() );
+        }
+        else if ( remaining_budget > 0 )
+        {
+            remaining_budget -= actor_instances.ResizeTowardsTargetCount( GetWorld(), remaining_budget );
+
+            UE_LOG( LogActorPool, Verbose, TEXT( "ResizePools : %s - Instance Count : %i" ), *GetNameSafe( key_pair.Key ), actor_instances.GetInstanceCount() );
+        }
+    }
+
+    if ( GetMemorySize() > memory_size )
+    {
+        EnforceMemoryBudget();
+    }
+}
+
+bool AActorPoolActor::IsResizingPools() const
+{
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        const auto & actor_instances = ActorPools[ key_pair.Value ];
+
+        if ( actor_instances.IsResizing() )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void AActorPoolActor::UpdateIdleInstancesClusters()
+{
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        ActorPools[ key_pair.Value ].UpdateIdleInstancesCluster( this );
+    }
+}
+
+void AActorPoolActor::UpdateIdleInstancesClustersTimer()
+{
+    auto is_clustering = false;
+
+    if ( GActorPoolClusterIdleInstances.GetValueOnGameThread() != 0 )
+    {
+        for ( const auto & key_pair : ActorPoolIndices )
+        {
+            const auto & actor_instances = ActorPools[ key_pair.Value ];
+
+            if ( actor_instances.GetPoolInfos().bClusterIdleInstances )
+            {
+                is_clustering = true;
+                break;
+            }
+        }
+    }
+
+    auto & timer_manager = GetWorldTimerManager();
+
+    if ( is_clustering == timer_manager.TimerExists( IdleInstancesClustersTimerHandle ) )
+    {
+        return;
+    }
+
+    if ( is_clustering )
+    {
+        timer_manager.SetTimer( IdleInstancesClustersTimerHandle, this, &ThisClass::UpdateIdleInstancesClusters, GActorPoolClusterUpdateInterval.GetValueOnGameThread(), true );
+    }
+    else
+    {
+        timer_manager.ClearTimer( IdleInstancesClustersTimerHandle );
+
+        // Dissolves the clusters left by the last update
+        UpdateIdleInstancesClusters();
+    }
+}
+
+FActorPoolInstances * AActorPoolActor::FindActorPool( TSubclassOf< AActor > actor_class )
+{
+    const auto * pool_index = ActorPoolIndices.Find( actor_class );
+    return pool_index != nullptr ? &ActorPools[ *pool_index ] : nullptr;
+}
+
+const FActorPoolInstances * AActorPoolActor::FindActorPool( TSubclassOf< AActor > actor_class ) const
+{
+    const auto * pool_index = ActorPoolIndices.Find( actor_class );
+    return pool_index != nullptr ? &ActorPools[ *pool_index ] : nullptr;
+}
+
+FActorPoolInstances * AActorPoolActor::FindPoolById( const int pool_id )
+{
+    return const_cast< FActorPoolInstances * >( static_cast< const AActorPoolActor * >( this )->FindPoolById( pool_id ) );
+}
+
+const FActorPoolInstances * AActorPoolActor::FindPoolById( const int pool_id ) const
+{
+    // The index is read from the id, and the serial of the id tells if the pool at that index is still the same
+    const auto pool_index = pool_id & PoolIndexMask;
+
+    if ( pool_id == INDEX_NONE || !ActorPools.IsValidIndex( pool_index ) || ActorPools[ pool_index ].GetPoolId() != pool_id )
+    {
+        return nullptr;
+    }
+
+    return &ActorPools[ pool_index ];
+}
+
+UInstancedStaticMeshComponent * AActorPoolActor::CreateProxyComponent( const FActorPoolInfos & pool_infos )
+{
+    auto * proxy_mesh = pool_infos.ProxyMesh.LoadSynchronous();
+
+    if ( proxy_mesh == nullptr )
+    {
+        return nullptr;
+    }
+
+    // The proxies are only visual, their transforms are in world space and they never collide
+    auto * proxy_component = NewObject< UInstancedStaticMeshComponent >( this );
+    proxy_component->SetStaticMesh( proxy_mesh );
+    proxy_component->SetCollisionEnabled( ECollisionEnabled::NoCollision );
+    proxy_component->SetCanEverAffectNavigation( false );
+    proxy_component->SetMobility( EComponentMobility::Movable );
+    proxy_component->RegisterComponent();
+
+    return proxy_component;
+}
+
+FActorPoolInstances & AActorPoolActor::AddActorPoolInstance( TSubclassOf< AActor > actor_class, const FActorPoolInfos & pool_infos, bool is_prewarm_deferred )
+{
+    TArray< AActor * > adopted_instances;
+
+    for ( TActorIterator< AAPBakedPoolInstancesActor > iterator( GetWorld() ); iterator; ++iterator )
+    {
+        adopted_instances.Append( iterator->TakeBakedInstances( pool_infos.ActorClass.Get() ) );
+    }
+
+    if ( pool_infos.bPersistAcrossSeamlessTravel && !pool_infos.bMatchReplicatedInstancesOnClients )
+    {
+        if ( auto * seamless_travel_subsystem = UGameInstance::GetSubsystem< UAPSeamlessTravelSubSystem >( GetGameInstance() ) )
+        {
+            adopted_instances.Append( seamless_travel_subsystem->TakeTravelingInstances( GetWorld(), pool_infos.ActorClass.Get() ) );
+        }
+    }
+
+    // The index of a removed pool is reused by the next one, and the serial in the high bits of the id invalidates the references to the removed pool
+    const auto pool_index = FreePoolIndices.Num() > 0 ? FreePoolIndices.Pop( false ) : ActorPools.AddDefaulted();
+    const auto pool_id = ( ( NextPoolSerial++ & PoolSerialMask ) << PoolIndexBits ) | pool_index;
+
+    auto & actor_pool_instances = ActorPools[ pool_index ];
+    actor_pool_instances = FActorPoolInstances( GetWorld(), pool_infos, pool_id, adopted_instances, is_prewarm_deferred );
+
+    if ( !pool_infos.ProxyMesh.IsNull() )
+    {
+        actor_pool_instances.SetProxyComponent( CreateProxyComponent( pool_infos ) );
+    }
+
+    ActorPoolIndices.Add( actor_class, pool_index );
+
+    return actor_pool_instances;
+}
+
+void AActorPoolActor::RemoveActorPoolInstance( TSubclassOf< AActor > actor_class )
+{
+    int pool_index;
+
+    if ( !ActorPoolIndices.RemoveAndCopyValue( actor_class, pool_index ) )
+    {
+        return;
+    }
+
+    // Leaves an empty pool at the index, whose id never matches a reference
+    ActorPools[ pool_index ] = FActorPoolInstances();
+    FreePoolIndices.Add( pool_index );
+}
+
+void AActorPoolActor::DestroyUnclaimedTravelingInstances()
+{
+    // The instances which traveled from the previous world but whose pool does not exist anymore are not needed
+    if ( auto * seamless_travel_subsystem = UGameInstance::GetSubsystem< UAPSeamlessTravelSubSystem >( GetGameInstance() ) )
+    {
+        seamless_travel_subsystem->DestroyUnclaimedInstances( GetWorld() );
+    }
+}
+
+void AActorPoolActor::DestroyBakedInstances( const UClass * actor_class )
+{
+    for ( TActorIterator< AAPBakedPoolInstancesActor > iterator( GetWorld() ); iterator; ++iterator )
+    {
+        for ( auto * instance : iterator->TakeBakedInstances( actor_class ) )
+        {
+            instance->Destroy();
+        }
+    }
+}
+
+void AActorPoolActor::ClaimBakedInstances( const ULevel * level )
+{
+    if ( level == nullptr )
+    {
+        return;
+    }
+
+    auto is_pool_grown = false;
+
+    // The pools created before the level was streamed in adopt the instances baked in it
+    for ( auto * actor : level->Actors )
+    {
+        auto * baked_instances_actor = Cast< AAPBakedPoolInstancesActor >( actor );
+
+        if ( baked_instances_actor == nullptr )
+        {
+            continue;
+        }
+
+        for ( const auto & key_pair : ActorPoolIndices )
+        {
+            auto & actor_instances = ActorPools[ key_pair.Value ];
+
+            const auto baked_instances = baked_instances_actor->TakeBakedInstances( key_pair.Key );
+
+            if ( baked_instances.Num() > 0 )
+            {
+                actor_instances.AdoptInstances( baked_instances );
+                is_pool_grown = true;
+            }
+        }
+
+        for ( const auto & skipped_pool_class : SkippedPoolClasses )
+        {
+            for ( auto * instance : baked_instances_actor->TakeBakedInstances( skipped_pool_class ) )
+            {
+                instance->Destroy();
+            }
+        }
+    }
+
+    if ( is_pool_grown )
+    {
+        EnforceMemoryBudget();
+    }
+}
+
+void AActorPoolActor::HandOverSeamlessTravelInstances( TArray< AActor * > & traveling_instances )
 {
-    return FActorPoolInstances( GetWorld(), pool_infos );
+    for ( const auto & key_pair : ActorPoolIndices )
+    {
+        auto & actor_instances = ActorPools[ key_pair.Value ];
+
+        const auto & pool_infos = actor_instances.GetPoolInfos();
+
+        if ( pool_infos.bPersistAcrossSeamlessTravel && !pool_infos.bMatchReplicatedInstancesOnClients )
+        {
+            actor_instances.ReleaseIdleInstances( traveling_instances );
+        }
+    }
 }
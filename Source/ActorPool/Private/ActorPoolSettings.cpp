@@ -1,5 +1,15 @@
 #include "ActorPoolSettings.h"
 
+#include <DeviceProfiles/DeviceProfile.h>
+#include <DeviceProfiles/DeviceProfileManager.h>
+
+static TAutoConsoleVariable< float > GActorPoolCountScale(
+    TEXT( "ActorPool.CountScale" ),
+    1.0f,
+    TEXT( "Multiplier applied to the count of the pools which have no override for the active device profile.\n" )
+        TEXT( "Set it in the device profiles or in the scalability groups. The pools are resized over several frames when it changes." ),
+    ECVF_Scalability );
+
 FAPPooledActorAcquireFromPoolSettings::FAPPooledActorAcquireFromPoolSettings() :
     bShowActor( true ),
     bEnableCollision( true ),
@@ -11,7 +21,50 @@ FActorPoolInfos::FActorPoolInfos() :
     Count( 0 ),
     PoolingPolicy( EAPPoolingPolicy::CreateNewInstances ),
     bSpawnOnServer( true ),
-    bSpawnOnClients( false )
+    bSpawnOnClients( false ),
+    bMatchReplicatedInstancesOnClients( false ),
+    bNeverReplicate( false ),
+    bResetToArchetypeOnReturn( false ),
+    PhysicsParkingMode( EAPPhysicsParkingMode::None ),
+    bUseParkingLocation( false ),
+    ParkingExtent( FVector::ZeroVector ),
+    ParkingSpacing( FVector::ZeroVector ),
+    bIsolateIdleInstances( false ),
+    bClusterIdleInstances( false ),
+    bPersistAcrossSeamlessTravel( false ),
+    StreamedOutPoolLifetime( 10.0f ),
+    Priority( 0 ),
+    MaxHeldDuration( 0.0f )
+{}
+
+int FActorPoolInfos::GetScaledCount() const
+{
+    if ( DeviceProfileCountOverrides.Num() > 0 )
+    {
+        for ( const auto * device_profile = UDeviceProfileManager::Get().GetActiveProfile(); device_profile != nullptr; device_profile = Cast< UDeviceProfile >( device_profile->Parent ) )
+        {
+            if ( const auto * count = DeviceProfileCountOverrides.Find( device_profile->GetName() ) )
+            {
+                return *count;
+            }
+        }
+    }
+
+    return FMath::Max( 0, FMath::RoundToInt( Count * GActorPoolCountScale.GetValueOnGameThread() ) );
+}
+
+FAPObjectPoolInfos::FAPObjectPoolInfos() :
+    Count( 0 ),
+    PoolingPolicy( EAPPoolingPolicy::CreateNewInstances ),
+    bSpawnOnServer( true ),
+    bSpawnOnClients( false ),
+    bResetToArchetypeOnReturn( false ),
+    MaxHeldDuration( 0.0f )
+{}
+
+UActorPoolSettings::UActorPoolSettings() :
+    MemoryBudget( 0 ),
+    DeferredReturnTickGroup( TG_PostUpdateWork )
 {}
 
 FName UActorPoolSettings::GetCategoryName() const
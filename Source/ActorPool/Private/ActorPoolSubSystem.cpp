@@ -1,10 +1,13 @@
 #include "ActorPoolSubSystem.h"
 
 #include "APPooledActorInterface.h"
+#include "APSeamlessTravelSubSystem.h"
 #include "ActorPoolActor.h"
 
+#include <Engine/GameInstance.h>
 #include <Engine/World.h>
 #include <HAL/IConsoleManager.h>
+#include <UObject/UObjectGlobals.h>
 
 #if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
 static FAutoConsoleCommandWithWorld GActorPoolDestroyInstancesInPools(
@@ -28,8 +31,62 @@ static FAutoConsoleCommandWithWorldArgsAndOutputDevice GActorPoolDumpPoolInfos(
         }
     } ),
     ECVF_Default );
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GActorPoolDumpHeldInstancesAges(
+    TEXT( "ActorPool.DumpHeldInstancesAges" ),
+    TEXT( "Dumps, for each pool, how long the acquired instances have been held and who holds the oldest one." ),
+    FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda( []( const TArray< FString > & /*args*/, const UWorld * world, FOutputDevice & output_device ) {
+        if ( const auto * system = world->GetSubsystem< UActorPoolSubSystem >() )
+        {
+            system->DumpHeldInstancesAges( output_device );
+        }
+    } ),
+    ECVF_Default );
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GActorPoolMeasureGarbageCollection(
+    TEXT( "ActorPool.MeasureGarbageCollection" ),
+    TEXT( "Runs a full garbage collection N times (10 by default) and logs its average duration. Compare the results with ActorPool.ClusterIdleInstances set to 0 and 1." ),
+    FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda( []( const TArray< FString > & args, const UWorld * /*world*/, FOutputDevice & output_device ) {
+        const auto count = args.Num() > 0 ? FMath::Max( 1, FCString::Atoi( *args[ 0 ] ) ) : 10;
+        auto total_duration = 0.0;
+        auto max_duration = 0.0;
+
+        for ( auto index = 0; index < count; ++index )
+        {
+            const auto start_time = FPlatformTime::Seconds();
+            CollectGarbage( GARBAGE_COLLECTION_KEEPFLAGS, true );
+            const auto duration = FPlatformTime::Seconds() - start_time;
+
+            total_duration += duration;
+            max_duration = FMath::Max( max_duration, duration );
+        }
+
+        output_device.Logf( ELogVerbosity::Display, TEXT( "Garbage collection over %i runs - Average : %.2f ms - Max : %.2f ms" ), count, total_duration * 1000.0 / count, max_duration * 1000.0 );
+    } ),
+    ECVF_Default );
 #endif
 
+// The callers are identified by their class, which is enough to find who leaks or returns instances twice
+static FName GetCallerTag( const UObject * caller )
+{
+    return caller != nullptr ? caller->GetClass()->GetFName() : NAME_None;
+}
+
+void UActorPoolSubSystem::Initialize( FSubsystemCollectionBase & collection )
+{
+    Super::Initialize( collection );
+
+    OnWorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject( this, &ThisClass::OnWorldPostActorTick );
+}
+
+void UActorPoolSubSystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove( OnWorldPostActorTickHandle );
+    PendingNetDormancies.Reset();
+
+    Super::Deinitialize();
+}
+
 bool UActorPoolSubSystem::IsActorPoolable( AActor * actor ) const
 {
     if ( actor == nullptr )
@@ -50,12 +107,47 @@ bool UActorPoolSubSystem::IsActorClassPoolable( const TSubclassOf< AActor > acto
     return ActorPoolActor->IsActorClassPoolable( actor_class );
 }
 
-FActorPoolRequestHandle UActorPoolSubSystem::GetActorFromPool( TSubclassOf< AActor > actor_class, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool )
+int UActorPoolSubSystem::GetIdleInstanceCount( TSubclassOf< AActor > actor_class ) const
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return 0;
+    }
+
+    return ActorPoolActor->GetIdleInstanceCount( actor_class );
+}
+
+int UActorPoolSubSystem::GetInstanceCount( TSubclassOf< AActor > actor_class ) const
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return 0;
+    }
+
+    return ActorPoolActor->GetInstanceCount( actor_class );
+}
+
+bool UActorPoolSubSystem::IsPoolDrivenByServer( TSubclassOf< AActor > actor_class ) const
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return false;
+    }
+
+    return ActorPoolActor->IsPoolDrivenByServer( actor_class );
+}
+
+FActorPoolRequestHandle UActorPoolSubSystem::GetActorFromPool( TSubclassOf< AActor > actor_class, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool, FName caller_tag )
 {
-    return GetActorFromPoolWithTransform( actor_class, FTransform::Identity, on_actor_got_from_pool );
+    return GetActorFromPoolWithTransform( actor_class, FTransform::Identity, on_actor_got_from_pool, caller_tag );
 }
 
-FActorPoolRequestHandle UActorPoolSubSystem::GetActorFromPoolWithTransform( TSubclassOf< AActor > actor_class, FTransform transform, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool )
+FActorPoolRequestHandle UActorPoolSubSystem::GetActorFromPoolWithTransform( TSubclassOf< AActor > actor_class, FTransform transform, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool, FName caller_tag )
+{
+    return GetActorFromPoolWithPayload( actor_class, transform, FInstancedStruct(), on_actor_got_from_pool, caller_tag );
+}
+
+FActorPoolRequestHandle UActorPoolSubSystem::GetActorFromPoolWithPayload( TSubclassOf< AActor > actor_class, FTransform transform, const FInstancedStruct & payload, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool, FName caller_tag )
 {
     if ( !ensureMsgf( ActorPoolActor != nullptr, TEXT( "%s - ActorPoolActor is not valid!" ), StringCast< TCHAR >( __FUNCTION__ ).Get() ) )
     {
@@ -63,19 +155,9 @@ FActorPoolRequestHandle UActorPoolSubSystem::GetActorFromPoolWithTransform( TSub
         return FActorPoolRequestHandle();
     }
 
-    if ( auto * actor = GetActorFromPoolWithTransformNoDeferred( actor_class, transform ) )
+    if ( auto * actor = ActorPoolActor->GetActorFromPool( actor_class, transform, caller_tag, &payload ) )
     {
-        if ( Cast< IAPPooledActorInterface >( actor ) )
-        {
-            if ( IAPPooledActorInterface::Execute_IsUsingDeferredAcquisitionFromPool( actor ) )
-            {
-                const auto & request = PendingActorRequests.Emplace_GetRef( on_actor_got_from_pool, actor, transform );
-                IAPPooledActorInterface::Execute_OnAquiredFromPoolDeferred( actor, request.Handle );
-                return request.Handle;
-            }
-        }
-
-        on_actor_got_from_pool.ExecuteIfBound( actor );
+        return HandOverAcquiredActor( actor, transform, on_actor_got_from_pool );
     }
 
     return FActorPoolRequestHandle();
@@ -87,7 +169,7 @@ FActorPoolRequestHandle UActorPoolSubSystem::K2_GetActorFromPool( TSubclassOf< A
         on_actor_got_from_pool.ExecuteIfBound( actor );
     } );
 
-    return GetActorFromPool( actor_class, delegate );
+    return GetActorFromPool( actor_class, delegate, GetCallerTag( on_actor_got_from_pool.GetUObject() ) );
 }
 
 FActorPoolRequestHandle UActorPoolSubSystem::K2_GetActorFromPoolWithTransform( TSubclassOf< AActor > actor_class, FTransform transform, FAPOnActorGotFromPoolDynamicDelegate on_actor_got_from_pool )
@@ -96,34 +178,213 @@ FActorPoolRequestHandle UActorPoolSubSystem::K2_GetActorFromPoolWithTransform( T
         on_actor_got_from_pool.ExecuteIfBound( actor );
     } );
 
-    return GetActorFromPoolWithTransform( actor_class, transform, delegate );
+    return GetActorFromPoolWithTransform( actor_class, transform, delegate, GetCallerTag( on_actor_got_from_pool.GetUObject() ) );
+}
+
+FActorPoolRequestHandle UActorPoolSubSystem::K2_GetActorFromPoolWithPayload( TSubclassOf< AActor > actor_class, FTransform transform, const FInstancedStruct & payload, FAPOnActorGotFromPoolDynamicDelegate on_actor_got_from_pool )
+{
+    const auto delegate = FAPOnActorGotFromPoolDelegate::CreateWeakLambda( const_cast< UObject * >( on_actor_got_from_pool.GetUObject() ), [ on_actor_got_from_pool ]( AActor * actor ) {
+        on_actor_got_from_pool.ExecuteIfBound( actor );
+    } );
+
+    return GetActorFromPoolWithPayload( actor_class, transform, payload, delegate, GetCallerTag( on_actor_got_from_pool.GetUObject() ) );
+}
+
+AActor * UActorPoolSubSystem::GetActorFromPoolWithTransformNoDeferred( TSubclassOf< AActor > actor_class, FTransform transform, const UObject * caller )
+{
+    if ( !ensureMsgf( ActorPoolActor != nullptr, TEXT( "%s - ActorPoolActor is not valid!" ), StringCast< TCHAR >( __FUNCTION__ ).Get() ) )
+    {
+        return nullptr;
+    }
+
+    return ActorPoolActor->GetActorFromPool( actor_class, transform, GetCallerTag( caller ) );
+}
+
+AActor * UActorPoolSubSystem::GetActorFromPoolWithPayloadNoDeferred( TSubclassOf< AActor > actor_class, FTransform transform, const FInstancedStruct & payload, const UObject * caller )
+{
+    if ( !ensureMsgf( ActorPoolActor != nullptr, TEXT( "%s - ActorPoolActor is not valid!" ), StringCast< TCHAR >( __FUNCTION__ ).Get() ) )
+    {
+        return nullptr;
+    }
+
+    return ActorPoolActor->GetActorFromPool( actor_class, transform, GetCallerTag( caller ), &payload );
+}
+
+bool UActorPoolSubSystem::ReturnActorToPool( AActor * actor, const UObject * caller )
+{
+    return ReturnActorToPoolWithTag( actor, GetCallerTag( caller ) );
+}
+
+bool UActorPoolSubSystem::ReturnActorToPoolWithTag( AActor * actor, FName caller_tag )
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return false;
+    }
+
+    return ActorPoolActor->ReturnActorToPool( actor, caller_tag );
+}
+
+bool UActorPoolSubSystem::ReturnActorToPoolDeferred( AActor * actor, const UObject * caller )
+{
+    return ReturnActorToPoolDeferredWithTag( actor, GetCallerTag( caller ) );
+}
+
+bool UActorPoolSubSystem::ReturnActorToPoolDeferredWithTag( AActor * actor, FName caller_tag )
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return false;
+    }
+
+    return ActorPoolActor->ReturnActorToPoolDeferred( actor, caller_tag );
+}
+
+FAPPooledProxyHandle UActorPoolSubSystem::AcquireProxy( TSubclassOf< AActor > actor_class, FTransform transform )
+{
+    if ( !ensureMsgf( ActorPoolActor != nullptr, TEXT( "%s - ActorPoolActor is not valid!" ), StringCast< TCHAR >( __FUNCTION__ ).Get() ) )
+    {
+        return FAPPooledProxyHandle();
+    }
+
+    return ActorPoolActor->AcquireProxy( actor_class, transform );
+}
+
+FAPPoolReservationHandle UActorPoolSubSystem::ReserveCapacity( TSubclassOf< AActor > actor_class, int count, float deadline )
+{
+    if ( !ensureMsgf( ActorPoolActor != nullptr, TEXT( "%s - ActorPoolActor is not valid!" ), StringCast< TCHAR >( __FUNCTION__ ).Get() ) )
+    {
+        return FAPPoolReservationHandle();
+    }
+
+    return ActorPoolActor->ReserveCapacity( actor_class, count, deadline );
+}
+
+bool UActorPoolSubSystem::ReleaseReservation( FAPPoolReservationHandle handle )
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return false;
+    }
+
+    return ActorPoolActor->ReleaseReservation( handle );
+}
+
+bool UActorPoolSubSystem::ReturnProxy( FAPPooledProxyHandle handle )
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return false;
+    }
+
+    return ActorPoolActor->ReturnProxy( handle );
+}
+
+FActorPoolRequestHandle UActorPoolSubSystem::HydrateProxy( FAPPooledProxyHandle handle, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool, FName caller_tag )
+{
+    if ( !ensureMsgf( ActorPoolActor != nullptr, TEXT( "%s - ActorPoolActor is not valid!" ), StringCast< TCHAR >( __FUNCTION__ ).Get() ) )
+    {
+        on_actor_got_from_pool.ExecuteIfBound( nullptr );
+        return FActorPoolRequestHandle();
+    }
+
+    FTransform transform;
+
+    if ( auto * actor = ActorPoolActor->HydrateProxy( handle, transform, caller_tag ) )
+    {
+        return HandOverAcquiredActor( actor, transform, on_actor_got_from_pool );
+    }
+
+    return FActorPoolRequestHandle();
+}
+
+FActorPoolRequestHandle UActorPoolSubSystem::K2_HydrateProxy( FAPPooledProxyHandle handle, FAPOnActorGotFromPoolDynamicDelegate on_actor_got_from_pool )
+{
+    const auto delegate = FAPOnActorGotFromPoolDelegate::CreateWeakLambda( const_cast< UObject * >( on_actor_got_from_pool.GetUObject() ), [ on_actor_got_from_pool ]( AActor * actor ) {
+        on_actor_got_from_pool.ExecuteIfBound( actor );
+    } );
+
+    return HydrateProxy( handle, delegate, GetCallerTag( on_actor_got_from_pool.GetUObject() ) );
 }
 
-AActor * UActorPoolSubSystem::GetActorFromPoolWithTransformNoDeferred( TSubclassOf< AActor > actor_class, FTransform transform )
+FAPPooledProxyHandle UActorPoolSubSystem::DehydrateActor( AActor * actor, const UObject * caller )
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return FAPPooledProxyHandle();
+    }
+
+    return ActorPoolActor->DehydrateActor( actor, GetCallerTag( caller ) );
+}
+
+UObject * UActorPoolSubSystem::GetObjectFromPool( TSubclassOf< UObject > object_class, const UObject * caller )
 {
     if ( !ensureMsgf( ActorPoolActor != nullptr, TEXT( "%s - ActorPoolActor is not valid!" ), StringCast< TCHAR >( __FUNCTION__ ).Get() ) )
     {
         return nullptr;
     }
 
-    if ( auto * actor = ActorPoolActor->GetActorFromPool( actor_class ) )
+    return ActorPoolActor->GetObjectFromPool( object_class, GetCallerTag( caller ) );
+}
+
+UActorComponent * UActorPoolSubSystem::GetComponentFromPool( TSubclassOf< UActorComponent > component_class, USceneComponent * attach_parent, FName socket_name, const UObject * caller )
+{
+    if ( !ensureMsgf( ActorPoolActor != nullptr, TEXT( "%s - ActorPoolActor is not valid!" ), StringCast< TCHAR >( __FUNCTION__ ).Get() ) )
     {
-        actor->SetActorLocation( transform.GetLocation() );
-        actor->SetActorRotation( transform.GetRotation() );
-        return actor;
+        return nullptr;
     }
 
-    return nullptr;
+    return ActorPoolActor->GetComponentFromPool( component_class, attach_parent, socket_name, GetCallerTag( caller ) );
 }
 
-bool UActorPoolSubSystem::ReturnActorToPool( AActor * actor )
+bool UActorPoolSubSystem::ReturnObjectToPool( UObject * object, const UObject * caller )
 {
     if ( ActorPoolActor == nullptr )
     {
         return false;
     }
 
-    return ActorPoolActor->ReturnActorToPool( actor );
+    return ActorPoolActor->ReturnObjectToPool( object, GetCallerTag( caller ) );
+}
+
+FAPPooledActorRef UActorPoolSubSystem::GetPooledActorRef( AActor * actor ) const
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return FAPPooledActorRef();
+    }
+
+    return ActorPoolActor->GetPooledActorRef( actor );
+}
+
+AActor * UActorPoolSubSystem::ResolvePooledActorRef( const FAPPooledActorRef & ref ) const
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return nullptr;
+    }
+
+    return ActorPoolActor->ResolvePooledActorRef( ref );
+}
+
+void UActorPoolSubSystem::GetSeamlessTravelActorList( TArray< AActor * > & actor_list )
+{
+    auto * seamless_travel_subsystem = UGameInstance::GetSubsystem< UAPSeamlessTravelSubSystem >( GetWorld()->GetGameInstance() );
+
+    if ( seamless_travel_subsystem == nullptr )
+    {
+        return;
+    }
+
+    // This is called once in the world we leave and once in the transition world, which has no pool but must keep the instances too
+    if ( ActorPoolActor != nullptr )
+    {
+        TArray< AActor * > traveling_instances;
+        ActorPoolActor->HandOverSeamlessTravelInstances( traveling_instances );
+        seamless_travel_subsystem->AddTravelingInstances( traveling_instances );
+    }
+
+    seamless_travel_subsystem->GetTravelingInstances( actor_list );
 }
 
 bool UActorPoolSubSystem::FinishAcquireActor( FActorPoolRequestHandle handle )
@@ -138,7 +399,7 @@ bool UActorPoolSubSystem::FinishAcquireActor( FActorPoolRequestHandle handle )
         const auto & request = PendingActorRequests[ index ];
         if ( request.Handle == handle )
         {
-            request.Actor->SetActorTransform( request.Transform );
+            request.Actor->SetActorTransform( request.Transform, false, nullptr, ETeleportType::ResetPhysics );
             request.Callback.ExecuteIfBound( request.Actor.Get() );
             PendingActorRequests.RemoveAt( index );
             return true;
@@ -148,6 +409,32 @@ bool UActorPoolSubSystem::FinishAcquireActor( FActorPoolRequestHandle handle )
     return false;
 }
 
+bool UActorPoolSubSystem::CancelAcquireActor( FActorPoolRequestHandle handle, FName caller_tag )
+{
+    if ( !handle.IsValid() )
+    {
+        return false;
+    }
+
+    for ( auto index = 0; index < PendingActorRequests.Num(); ++index )
+    {
+        if ( PendingActorRequests[ index ].Handle == handle )
+        {
+            auto * actor = PendingActorRequests[ index ].Actor.Get();
+            PendingActorRequests.RemoveAt( index );
+
+            if ( actor != nullptr )
+            {
+                ReturnActorToPoolWithTag( actor, caller_tag );
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void UActorPoolSubSystem::RegisterActorPoolActor( AActorPoolActor * actor_pool_actor )
 {
     if ( !ensureAlwaysMsgf( actor_pool_actor != nullptr, TEXT( "Actor Pool Actor is not valid!" ) ) )
@@ -188,6 +475,52 @@ void UActorPoolSubSystem::UnRegisterPooledActor( const FActorPoolInfos & actor_p
     ActorPoolActor->UnRegisterPooledActor( actor_pool_infos );
 }
 
+void UActorPoolSubSystem::QueueNetDormancy( AActor * actor, const ENetDormancy net_dormancy, const bool force_net_update )
+{
+    if ( !CanQueueNetDormancy( actor ) )
+    {
+        return;
+    }
+
+    auto & pending_net_dormancy = PendingNetDormancies.FindOrAdd( actor );
+    pending_net_dormancy.NetDormancy = net_dormancy;
+    pending_net_dormancy.bHasNetDormancy = true;
+    pending_net_dormancy.bForceNetUpdate |= force_net_update;
+}
+
+void UActorPoolSubSystem::QueueForceNetUpdate( AActor * actor )
+{
+    if ( !CanQueueNetDormancy( actor ) )
+    {
+        return;
+    }
+
+    PendingNetDormancies.FindOrAdd( actor ).bForceNetUpdate = true;
+}
+
+void UActorPoolSubSystem::MirrorServerInstance( AActor * actor, const bool is_acquired )
+{
+    if ( ActorPoolActor == nullptr )
+    {
+        return;
+    }
+
+    ActorPoolActor->MirrorServerInstance( actor, is_acquired );
+}
+
+void UActorPoolSubSystem::DropAcquireRequests( const AActor * actor )
+{
+    PendingActorRequests.RemoveAll( [ & ]( const PendingActorRequest & request ) {
+        return request.Actor.Get() == actor;
+    } );
+}
+
+bool UActorPoolSubSystem::CanQueueNetDormancy( const AActor * actor ) const
+{
+    // Only the server replicates the actors
+    return actor != nullptr && actor->GetIsReplicated() && actor->GetLocalRole() == ROLE_Authority && GetWorld()->GetNetMode() != NM_Standalone;
+}
+
 #if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
 void UActorPoolSubSystem::DestroyUnusedInstancesInPools()
 {
@@ -199,6 +532,16 @@ void UActorPoolSubSystem::DestroyUnusedInstancesInPools()
     ActorPoolActor->DestroyUnusedInstancesInPools();
 }
 
+void UActorPoolSubSystem::DumpHeldInstancesAges( FOutputDevice & output_device ) const
+{
+    if ( !ensureMsgf( ActorPoolActor != nullptr, TEXT( "%s - ActorPoolActor is not valid!" ), StringCast< TCHAR >( __FUNCTION__ ).Get() ) )
+    {
+        return;
+    }
+
+    ActorPoolActor->DumpHeldInstancesAges( output_device );
+}
+
 void UActorPoolSubSystem::DumpPoolInfos( FOutputDevice & output_device ) const
 {
     if ( !ensureMsgf( ActorPoolActor != nullptr, TEXT( "%s - ActorPoolActor is not valid!" ), StringCast< TCHAR >( __FUNCTION__ ).Get() ) )
@@ -216,4 +559,54 @@ void UActorPoolSubSystem::BroadcastOnActorPoolReadyEvent()
     {
         event.ExecuteIfBound( ActorPoolActor );
     }
+}
+
+void UActorPoolSubSystem::OnWorldPostActorTick( UWorld * world, ELevelTick /*tick_type*/, float /*delta_seconds*/ )
+{
+    // Broadcast after the actors ticked and before the net driver replicates them
+    if ( world == GetWorld() )
+    {
+        FlushPendingNetDormancies();
+    }
+}
+
+FActorPoolRequestHandle UActorPoolSubSystem::HandOverAcquiredActor( AActor * actor, const FTransform & transform, const FAPOnActorGotFromPoolDelegate & on_actor_got_from_pool )
+{
+    if ( Cast< IAPPooledActorInterface >( actor ) )
+    {
+        if ( IAPPooledActorInterface::Execute_IsUsingDeferredAcquisitionFromPool( actor ) )
+        {
+            const auto & request = PendingActorRequests.Emplace_GetRef( on_actor_got_from_pool, actor, transform );
+            IAPPooledActorInterface::Execute_OnAquiredFromPoolDeferred( actor, request.Handle );
+            return request.Handle;
+        }
+    }
+
+    on_actor_got_from_pool.ExecuteIfBound( actor );
+    return FActorPoolRequestHandle();
+}
+
+void UActorPoolSubSystem::FlushPendingNetDormancies()
+{
+    for ( const auto & key_pair : PendingNetDormancies )
+    {
+        auto * actor = key_pair.Key.Get();
+
+        if ( actor == nullptr )
+        {
+            continue;
+        }
+
+        if ( key_pair.Value.bHasNetDormancy && actor->NetDormancy != key_pair.Value.NetDormancy )
+        {
+            actor->SetNetDormancy( key_pair.Value.NetDormancy );
+        }
+
+        if ( key_pair.Value.bForceNetUpdate && actor->NetDormancy <= DORM_Awake )
+        {
+            actor->ForceNetUpdate();
+        }
+    }
+
+    PendingNetDormancies.Reset();
 }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <UObject/Class.h>
+#include <UObject/WeakObjectPtrTemplates.h>
+
+class FProperty;
+
+// Caches the values of the properties declared by a pooled class, as found in its class default object,
+// so instances can be reset to those values without going through the blueprint VM.
+// Plain old data properties are merged in contiguous spans and copied from a packed buffer. The other properties go through their FProperty,
+// and the replicated ones are marked dirty for the push model replication.
+struct ACTORPOOL_API FAPArchetypeSnapshot
+{
+    void Initialize( const UClass * object_class );
+    void Reset();
+    bool IsValid() const;
+
+    // Returns the number of spans and properties which had to be restored
+    int RestoreArchetypeValues( UObject * object ) const;
+
+private:
+    struct FPlainOldDataSpan
+    {
+        int Offset;
+        int Size;
+        int ValueOffset;
+    };
+
+    static bool CanRestoreProperty( const UClass * object_class, const FProperty * property );
+    // The script packages of the modules of the project and of its plugins. The other native classes belong to the engine or to its plugins
+    static const TSet< FName > & GetGameScriptPackageNames();
+
+    TWeakObjectPtr< const UClass > ObjectClass;
+    TWeakObjectPtr< const UObject > Archetype;
+    TArray< FPlainOldDataSpan > PlainOldDataSpans;
+    TArray< uint8 > PlainOldDataValues;
+    TArray< const FProperty * > ComplexProperties;
+    TArray< const FProperty * > ReplicatedProperties;
+};
+
+FORCEINLINE bool FAPArchetypeSnapshot::IsValid() const
+{
+    return ObjectClass.IsValid() && ( PlainOldDataSpans.Num() > 0 || ComplexProperties.Num() > 0 || ReplicatedProperties.Num() > 0 );
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ActorPoolActor.h"
+
+#include <CoreMinimal.h>
+#include <Kismet/BlueprintAsyncActionBase.h>
+
+#include "APAsyncAction_GetActorFromPool.generated.h"
+
+struct FStreamableHandle;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FAPOnAsyncActorGotFromPoolDelegate, AActor *, Actor );
+
+// Acquires an actor from a pool without blocking: waits for the class to be loaded, for the pools to be ready,
+// for the growth budget of the frame when the pool is empty, and for the deferred acquisition of the actor.
+// Completed is called once, with a null actor if the timeout, in game time, expires first or if the pool is driven by the server
+UCLASS()
+class ACTORPOOL_API UAPAsyncAction_GetActorFromPool final : public UBlueprintAsyncActionBase
+{
+    GENERATED_BODY()
+
+public:
+    UFUNCTION( BlueprintCallable, DisplayName = "GetActorFromPool - Async", meta = ( BlueprintInternalUseOnly = "true", WorldContext = "world_context_object" ) )
+    static UAPAsyncAction_GetActorFromPool * GetActorFromPoolAsync( UObject * world_context_object, TSoftClassPtr< AActor > actor_class, FTransform transform, float timeout = 5.0f );
+
+    void Activate() override;
+
+    UPROPERTY( BlueprintAssignable )
+    FAPOnAsyncActorGotFromPoolDelegate Completed;
+
+private:
+    void OnClassLoaded();
+    void OnActorPoolReady( AActorPoolActor * actor_pool_actor );
+    void TryAcquireActor();
+    void OnActorGotFromPool( AActor * actor );
+    void OnTimeout();
+    void Finish( AActor * actor );
+    bool HasGrowthBudget() const;
+    void ConsumeGrowthBudget() const;
+    static int32 & GetGrowthCountOfFrame();
+
+    TWeakObjectPtr< UWorld > World;
+    TSoftClassPtr< AActor > ActorClass;
+    FTransform Transform;
+    FName CallerTag;
+    TSharedPtr< FStreamableHandle > StreamableHandle;
+    FActorPoolRequestHandle RequestHandle;
+    FTimerHandle TimeoutTimerHandle;
+    float Timeout;
+    uint8 bIsFinished : 1;
+};
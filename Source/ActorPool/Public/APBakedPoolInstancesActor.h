@@ -0,0 +1,37 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <GameFramework/Actor.h>
+
+#include "APBakedPoolInstancesActor.generated.h"
+
+// Holds pool instances spawned in the editor and saved with its level, so they are loaded with the package
+// and adopted by the pools at runtime instead of being spawned one by one
+UCLASS( NotBlueprintable, HideCategories = ( Rendering, Physics, Collision, Input, LOD, Cooking, Replication ) )
+class ACTORPOOL_API AAPBakedPoolInstancesActor final : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    AAPBakedPoolInstancesActor();
+
+    // Removes from this actor the instances of the given class, for the pool of that class to adopt them
+    TArray< AActor * > TakeBakedInstances( const UClass * actor_class );
+
+#if WITH_EDITOR
+    // Spawns in the level of this actor the instances of the pools of the settings, parked and hidden
+    UFUNCTION( CallInEditor, Category = "Actor Pool" )
+    void BakePoolInstances();
+
+    UFUNCTION( CallInEditor, Category = "Actor Pool" )
+    void ClearBakedInstances();
+#endif
+
+private:
+    // The classes of the pools to bake. Leave empty to bake all the pools of the settings
+    UPROPERTY( EditAnywhere, Category = "Actor Pool" )
+    TArray< TSoftClassPtr< AActor > > ActorClasses;
+
+    UPROPERTY( VisibleAnywhere, Category = "Actor Pool" )
+    TArray< AActor * > BakedInstances;
+};
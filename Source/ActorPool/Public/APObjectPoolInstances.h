@@ -0,0 +1,79 @@
+#pragma once
+
+#include "APArchetypeSnapshot.h"
+#include "APPoolSlots.h"
+#include "ActorPoolSettings.h"
+
+#include <CoreMinimal.h>
+
+#include "APObjectPoolInstances.generated.h"
+
+class USceneComponent;
+
+// Pool of actor components or plain objects, sharing the slot bookkeeping and the pooling policy of the actor pools.
+// Unlike the actor pools, they are only created from the settings, are not scaled, and don't count in the memory budget
+USTRUCT()
+struct FAPObjectPoolInstances
+{
+    GENERATED_USTRUCT_BODY()
+
+public:
+    FAPObjectPoolInstances();
+    FAPObjectPoolInstances( UObject * outer, const FAPObjectPoolInfos & pool_infos );
+
+    // attach_parent and socket_name are only used by the scene components
+    UObject * GetAvailableInstance( USceneComponent * attach_parent, FName socket_name, FName caller_tag );
+    bool ReturnObject( UObject * object, FName caller_tag );
+    void DestroyObjects();
+    void DestroyUnusedInstances();
+
+    int GetInstanceCount() const;
+    int GetIdleInstanceCount() const;
+    int64 GetMemorySize() const;
+    const FAPObjectPoolInfos & GetPoolInfos() const;
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+    void ReportHeldInstances( double now );
+    void DumpHeldInstancesAges( FOutputDevice & output_device, double now ) const;
+    void DumpPoolInfos( FOutputDevice & output_device ) const;
+#endif
+
+private:
+    UObject * CreateObject() const;
+    UObject * CreateObjectAndAddToInstances();
+    void EnableObject( UObject * object, USceneComponent * attach_parent, FName socket_name ) const;
+    void DisableObject( UObject * object ) const;
+    static void DestroyObject( UObject * object );
+
+    // Indexed by slot. Empty slots hold nullptr
+    UPROPERTY()
+    TArray< UObject * > Instances;
+
+    UPROPERTY()
+    UObject * Outer;
+
+    FAPPoolSlots Slots;
+    FAPObjectPoolInfos PoolInfos;
+    FAPArchetypeSnapshot ArchetypeSnapshot;
+    int64 InstanceMemorySize;
+};
+
+FORCEINLINE int FAPObjectPoolInstances::GetInstanceCount() const
+{
+    return Slots.GetAvailableSlotCount() + Slots.GetAcquiredSlotCount();
+}
+
+FORCEINLINE int FAPObjectPoolInstances::GetIdleInstanceCount() const
+{
+    return Slots.GetAvailableSlotCount();
+}
+
+FORCEINLINE int64 FAPObjectPoolInstances::GetMemorySize() const
+{
+    return InstanceMemorySize * GetInstanceCount();
+}
+
+FORCEINLINE const FAPObjectPoolInfos & FAPObjectPoolInstances::GetPoolInfos() const
+{
+    return PoolInfos;
+}
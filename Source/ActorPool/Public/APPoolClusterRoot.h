@@ -0,0 +1,27 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <UObject/Object.h>
+
+#include "APPoolClusterRoot.generated.h"
+
+// Root of a garbage collection cluster holding the idle instances of a pool.
+// The garbage collector marks a whole cluster reachable at once instead of walking the references of each of its objects,
+// which is valid as long as the idle instances don't change their references
+UCLASS( Transient )
+class ACTORPOOL_API UAPPoolClusterRoot final : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    bool CanBeClusterRoot() const override;
+
+    // Dissolves the current cluster and creates a new one with the given instances
+    void Rebuild( const TArray< AActor * > & instances );
+    void Dissolve();
+    bool IsClustered() const;
+
+private:
+    UPROPERTY()
+    TArray< AActor * > Instances;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "APPoolReservationHandle.generated.h"
+
+// Identifies a capacity reservation made on a pool, to release it once the reserved instances are not needed anymore
+USTRUCT( BlueprintType )
+struct ACTORPOOL_API FAPPoolReservationHandle
+{
+    GENERATED_USTRUCT_BODY()
+
+    FAPPoolReservationHandle() :
+        PoolId( INDEX_NONE ),
+        ReservationId( INDEX_NONE )
+    {
+    }
+
+    FAPPoolReservationHandle( int32 pool_id, int32 reservation_id ) :
+        PoolId( pool_id ),
+        ReservationId( reservation_id )
+    {
+    }
+
+    bool IsValid() const
+    {
+        return PoolId != INDEX_NONE && ReservationId != INDEX_NONE;
+    }
+
+    UPROPERTY()
+    int32 PoolId;
+
+    // Never reused in a pool, so a released reservation can't be released twice
+    UPROPERTY()
+    int32 ReservationId;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "ActorPoolSettings.h"
+
+#include <CoreMinimal.h>
+
+enum class EAPPoolSlotState : uint8
+{
+    Empty,
+    Available,
+    Acquired
+};
+
+struct FAPPoolSlot
+{
+    FAPPoolSlot();
+
+    double AcquireTime;
+    FName CallerTag;
+    // Bumped each time the slot is released, reused or removed, so references to a previous acquisition can be detected
+    int32 Generation;
+    // Links to the neighbours of the slot in the list of its state
+    int32 PreviousIndex;
+    int32 NextIndex;
+    EAPPoolSlotState State;
+    uint8 bIsReportedAsHeld : 1;
+};
+
+// Bookkeeping of the slots of a pool, independent of the type of the pooled objects.
+// A slot keeps its index for its whole lifetime, so the pooled objects can be stored in a parallel array.
+// Available slots are reused last in first out. Acquired slots are kept in acquisition order, oldest first.
+// Both lists are linked through the slots, so acquiring, releasing and removing a slot never shifts an array.
+class ACTORPOOL_API FAPPoolSlots
+{
+public:
+    // Returns the index of a new available slot. Empty slots are reused first
+    int AddSlot();
+    void RemoveSlot( int slot_index );
+    void Reset();
+
+    // Returns INDEX_NONE when no slot is available
+    int AcquireSlot( double acquire_time, FName caller_tag );
+    // Acquires again the slot which has been acquired for the longest time. Returns INDEX_NONE when no slot is acquired
+    int ReacquireOldestSlot( double acquire_time, FName caller_tag );
+    // Acquires an available slot. When there is none, applies the pooling policy: create_instance must add a slot and return true on success.
+    // must_grow makes a pool using LoopInstances create an instance too. is_recycled is set when an acquired slot is acquired again
+    int AcquireSlotWithPolicy( EAPPoolingPolicy pooling_policy, bool must_grow, double acquire_time, FName caller_tag, TFunctionRef< bool() > create_instance, bool & is_recycled );
+    // Acquires the given slot. Returns false if the slot was not available
+    bool AcquireSlotAt( int slot_index, double acquire_time, FName caller_tag );
+    // Returns false if the slot was not acquired
+    bool ReleaseSlot( int slot_index );
+
+    int GetSlotCount() const;
+    int GetAvailableSlotCount() const;
+    int GetAcquiredSlotCount() const;
+    int GetLastAvailableSlotIndex() const;
+    const FAPPoolSlot & GetSlot( int slot_index ) const;
+    FAPPoolSlot & GetSlot( int slot_index );
+
+    // True when ActorPool.ForceInstanceCreationWhenPoolIsEmpty is on. Always false in shipping and test builds
+    static bool IsInstanceCreationForced();
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+    // Logs the total, acquired and available slot counts of a pool
+    void DumpSlotCounts( FOutputDevice & output_device ) const;
+    // Returns the acquired slots held for longer than the given duration which have not been reported yet, and flags them as reported
+    TArray< int > ReportSlotsHeldLongerThan( double now, double max_held_duration );
+    // Logs a histogram of how long the acquired slots have been held, and the caller of the oldest one
+    void DumpAcquiredSlotsAges( FOutputDevice & output_device, double now ) const;
+#endif
+
+private:
+    struct SlotList
+    {
+        SlotList();
+
+        int Head;
+        int Tail;
+        int Count;
+    };
+
+    void MarkAcquired( int slot_index, double acquire_time, FName caller_tag );
+    void LinkSlot( SlotList & slot_list, int slot_index );
+    void UnlinkSlot( SlotList & slot_list, int slot_index );
+
+    TArray< FAPPoolSlot > Slots;
+    TArray< int > EmptySlotIndices;
+    SlotList AvailableSlots;
+    SlotList AcquiredSlots;
+};
+
+FORCEINLINE int FAPPoolSlots::GetSlotCount() const
+{
+    return Slots.Num();
+}
+
+FORCEINLINE int FAPPoolSlots::GetAvailableSlotCount() const
+{
+    return AvailableSlots.Count;
+}
+
+FORCEINLINE int FAPPoolSlots::GetAcquiredSlotCount() const
+{
+    return AcquiredSlots.Count;
+}
+
+FORCEINLINE int FAPPoolSlots::GetLastAvailableSlotIndex() const
+{
+    return AvailableSlots.Tail;
+}
+
+FORCEINLINE const FAPPoolSlot & FAPPoolSlots::GetSlot( int slot_index ) const
+{
+    return Slots[ slot_index ];
+}
+
+FORCEINLINE FAPPoolSlot & FAPPoolSlots::GetSlot( int slot_index )
+{
+    return Slots[ slot_index ];
+}
@@ -3,6 +3,7 @@
 #include "ActorPoolActor.h"
 
 #include <CoreMinimal.h>
+#include <InstancedStruct.h>
 #include <UObject/Interface.h>
 
 #include "APPooledActorInterface.generated.h"
@@ -18,6 +19,7 @@ class ACTORPOOL_API IAPPooledActorInterface
     GENERATED_BODY()
 
 public:
+    // Called after the actor is moved to its transform, before the payload and before the actor becomes visible and collidable
     UFUNCTION( BlueprintNativeEvent, BlueprintCallable )
     void OnAcquiredFromPool();
 
@@ -29,4 +31,12 @@ public:
 
     UFUNCTION( BlueprintNativeEvent, BlueprintCallable )
     void OnReturnedToPool();
+
+    // Called with the payload given to the acquisition, after OnAcquiredFromPool but before the actor becomes visible and collidable
+    UFUNCTION( BlueprintNativeEvent, BlueprintCallable )
+    void OnAcquiredFromPoolWithPayload( const FTransform & transform, const FInstancedStruct & payload );
+
+    // Native fast path of OnAcquiredFromPoolWithPayload for the C++ classes, called without going through the reflection.
+    // Return true when the payload has been applied, to skip the blueprint event
+    virtual bool ApplyAcquirePayload( const FTransform & transform, const FInstancedStruct & payload );
 };
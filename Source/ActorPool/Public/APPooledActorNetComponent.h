@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Components/ActorComponent.h>
+#include <CoreMinimal.h>
+
+#include "APPooledActorNetComponent.generated.h"
+
+// Added to the prewarmed instances of the pools which match the replicated instances on clients.
+// Replicates whether the server acquired the instance, so the clients mirror the acquisitions and returns when they are received
+UCLASS( Transient )
+class ACTORPOOL_API UAPPooledActorNetComponent final : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UAPPooledActorNetComponent();
+
+    void GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & lifetime_properties ) const override;
+
+    void SetIsAcquired( bool is_acquired );
+
+private:
+    UFUNCTION()
+    void OnRep_IsAcquired();
+
+    UPROPERTY( ReplicatedUsing = OnRep_IsAcquired )
+    uint8 bIsAcquired : 1;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "APPooledActorRef.generated.h"
+
+// Reference to an acquired pooled actor which can be cached by long-lived systems.
+// It stops resolving as soon as the actor is returned to its pool, even if the same instance is acquired again later.
+USTRUCT( BlueprintType )
+struct ACTORPOOL_API FAPPooledActorRef
+{
+    GENERATED_USTRUCT_BODY()
+
+    FAPPooledActorRef() :
+        PoolId( INDEX_NONE ),
+        SlotIndex( INDEX_NONE ),
+        Generation( 0 )
+    {
+    }
+
+    FAPPooledActorRef( int32 pool_id, int32 slot_index, int32 generation ) :
+        PoolId( pool_id ),
+        SlotIndex( slot_index ),
+        Generation( generation )
+    {
+    }
+
+    bool IsValid() const
+    {
+        return PoolId != INDEX_NONE && SlotIndex != INDEX_NONE;
+    }
+
+    bool operator==( const FAPPooledActorRef & other ) const
+    {
+        return PoolId == other.PoolId && SlotIndex == other.SlotIndex && Generation == other.Generation;
+    }
+
+    bool operator!=( const FAPPooledActorRef & other ) const
+    {
+        return !( *this == other );
+    }
+
+    friend uint32 GetTypeHash( const FAPPooledActorRef & ref )
+    {
+        return HashCombine( HashCombine( ::GetTypeHash( ref.PoolId ), ::GetTypeHash( ref.SlotIndex ) ), ::GetTypeHash( ref.Generation ) );
+    }
+
+    FString ToString() const
+    {
+        return FString::Printf( TEXT( "%d:%d:%d" ), PoolId, SlotIndex, Generation );
+    }
+
+    void Invalidate()
+    {
+        *this = FAPPooledActorRef();
+    }
+
+    // Holds the index of the pool and a serial which changes each time the index is reused, so a reference can't resolve to the pool which replaced its own
+    UPROPERTY()
+    int32 PoolId;
+
+    UPROPERTY()
+    int32 SlotIndex;
+
+    // Bumped each time the slot is released or reused
+    UPROPERTY()
+    int32 Generation;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "APPooledProxyHandle.generated.h"
+
+// Identifies a proxy of a pooled actor, which is a row of the instanced static mesh of its pool
+USTRUCT( BlueprintType )
+struct ACTORPOOL_API FAPPooledProxyHandle
+{
+    GENERATED_USTRUCT_BODY()
+
+    FAPPooledProxyHandle() :
+        PoolId( INDEX_NONE ),
+        ProxyId( INDEX_NONE )
+    {
+    }
+
+    FAPPooledProxyHandle( int32 pool_id, int32 proxy_id ) :
+        PoolId( pool_id ),
+        ProxyId( proxy_id )
+    {
+    }
+
+    bool IsValid() const
+    {
+        return PoolId != INDEX_NONE && ProxyId != INDEX_NONE;
+    }
+
+    bool operator==( const FAPPooledProxyHandle & other ) const
+    {
+        return PoolId == other.PoolId && ProxyId == other.ProxyId;
+    }
+
+    bool operator!=( const FAPPooledProxyHandle & other ) const
+    {
+        return !( *this == other );
+    }
+
+    friend uint32 GetTypeHash( const FAPPooledProxyHandle & handle )
+    {
+        return HashCombine( ::GetTypeHash( handle.PoolId ), ::GetTypeHash( handle.ProxyId ) );
+    }
+
+    FString ToString() const
+    {
+        return FString::Printf( TEXT( "%d:%d" ), PoolId, ProxyId );
+    }
+
+    void Invalidate()
+    {
+        *this = FAPPooledProxyHandle();
+    }
+
+    UPROPERTY()
+    int32 PoolId;
+
+    // Never reused in a pool, so a handle to a removed proxy stays invalid
+    UPROPERTY()
+    int32 ProxyId;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Subsystems/GameInstanceSubsystem.h>
+
+#include "APSeamlessTravelSubSystem.generated.h"
+
+// Keeps the idle instances of the pools flagged with bPersistAcrossSeamlessTravel while the game travels seamlessly,
+// so the pools of the destination world adopt them instead of spawning new instances
+UCLASS()
+class ACTORPOOL_API UAPSeamlessTravelSubSystem final : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    void AddTravelingInstances( const TArray< AActor * > & instances );
+    void GetTravelingInstances( TArray< AActor * > & actor_list ) const;
+
+    // Removes from the store the instances of the given class which live in the given world
+    TArray< AActor * > TakeTravelingInstances( const UWorld * world, const UClass * actor_class );
+
+    // Destroys the instances of the given world which have not been adopted by any pool
+    void DestroyUnclaimedInstances( const UWorld * world );
+
+private:
+    // The instances are owned by their level, the store must not keep the world they leave alive
+    TArray< TWeakObjectPtr< AActor > > TravelingInstances;
+};
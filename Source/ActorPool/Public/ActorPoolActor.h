@@ -1,15 +1,25 @@
 ﻿#pragma once
 
+#include "APArchetypeSnapshot.h"
+#include "APObjectPoolInstances.h"
+#include "APPoolClusterRoot.h"
+#include "APPoolReservationHandle.h"
+#include "APPoolSlots.h"
+#include "APPooledActorRef.h"
+#include "APPooledProxyHandle.h"
 #include "ActorPoolSettings.h"
 
 #include <CoreMinimal.h>
 #include <GameFramework/Actor.h>
+#include <HAL/IConsoleManager.h>
 
 #include "ActorPoolActor.generated.h"
 
 DECLARE_DELEGATE_OneParam( FAPOnActorGotFromPoolDelegate, AActor * Actor );
 
+class UInstancedStaticMeshComponent;
 struct FActorPoolInfos;
+struct FInstancedStruct;
 
 USTRUCT( BlueprintType )
 struct ACTORPOOL_API FActorPoolRequestHandle
@@ -74,28 +84,225 @@ struct FActorPoolInstances
 
 public:
     FActorPoolInstances();
-    FActorPoolInstances( UWorld * world, const FActorPoolInfos & pool_infos );
-
-    AActor * GetAvailableInstance( UWorld * world );
-    bool ReturnActor( AActor * actor );
+    // When is_prewarm_deferred is set, the instances are spawned over the frames by the resizing of the pool instead of all at once
+    FActorPoolInstances( UWorld * world, const FActorPoolInfos & pool_infos, int pool_id, const TArray< AActor * > & adopted_instances, bool is_prewarm_deferred = false );
+
+    // When set, the payload is delivered to the actor after OnAcquiredFromPool, before the actor becomes visible and collidable
+    AActor * GetAvailableInstance( UWorld * world, const FTransform & transform, FName caller_tag, const FInstancedStruct * payload = nullptr );
+    bool ReturnActor( AActor * actor, FName caller_tag );
+    // Returns the instance held by the slot, for the callers which already resolved it through a reference
+    bool ReturnInstance( int slot_index, FName caller_tag );
+    // Returns the instances of the references which still resolve in one batch, dissolving the cluster once. Returns the number of returned instances
+    int ReturnInstances( const TArray< FAPPooledActorRef > & refs );
+    FAPPooledActorRef GetActorRef( const AActor * actor ) const;
+    AActor * ResolveActorRef( const FAPPooledActorRef & ref ) const;
     void DestroyActors();
     void DestroyUnusedInstances();
+    int DestroyIdleInstances( int count );
+    // Adds to the pool instances baked in a level streamed in after the pool was created
+    void AdoptInstances( const TArray< AActor * > & instances );
+    // Removes the idle instances from the pool without destroying them
+    void ReleaseIdleInstances( TArray< AActor * > & released_instances );
+    // Removes the acquired instances from the pool without destroying them
+    void ReleaseAcquiredInstances( TArray< AActor * > & released_instances );
+    // Removes the instances which belong to a level being streamed out. Returns the number of removed instances
+    int RemoveInstancesOfLevel( const ULevel * level );
+    // Rebuilds the cluster of the idle instances if instances have been returned or acquired since the last update
+    void UpdateIdleInstancesCluster( UObject * outer );
+    // Resolves again the scaled count of the pool. Returns true if the pool must be resized to reach it
+    bool UpdateTargetCount();
+    // Spawns or destroys at most max_count idle instances to get closer to the target count plus the reserved count. Returns the number of instances spawned or destroyed
+    int ResizeTowardsTargetCount( UWorld * world, int max_count );
+    // Leaves the pool at its current count until its target or its reservations change
+    void StopResizing();
+    bool IsResizing() const;
+    // On clients, applies to an instance of a pool driven by the server the acquisition or the return the server replicated
+    void MirrorServerInstance( AActor * instance, bool is_acquired );
+
+    // Grows the pool by count instances, by the given time at the latest. Returns the id of the reservation
+    int AddReservation( int count, double deadline );
+    bool RemoveReservation( int reservation_id );
+    // Returns true if a reservation is past its deadline while the pool is still growing
+    bool IsReservationDeadlineReached( double now ) const;
+
+    void SetProxyComponent( UInstancedStaticMeshComponent * proxy_component );
+    // Returns INDEX_NONE if the pool has no proxy mesh
+    int AcquireProxy( const FTransform & transform );
+    bool ReturnProxy( int proxy_id );
+    // Returns false if there is no proxy with that id
+    bool GetProxyTransform( int proxy_id, FTransform & transform ) const;
+    // Returns the actor to the pool and replaces it by a proxy at its transform. Returns INDEX_NONE if the actor could not be returned
+    int DehydrateActor( AActor * actor, FName caller_tag );
+    int GetProxyCount() const;
+    int GetPoolId() const;
+    int GetInstanceCount() const;
+    int GetIdleInstanceCount() const;
+    // The idle instances which can be evicted by the memory budget. The reserved ones are kept
+    int GetEvictableInstanceCount() const;
+    int64 GetInstanceMemorySize() const;
+    int64 GetMemorySize() const;
+    int GetPriority() const;
+    double GetLastAcquireTime() const;
+    bool IsDrivenByServer() const;
+    const FActorPoolInfos & GetPoolInfos() const;
+
+    // The cell of the parking grid of the pool where the instance of the slot is parked
+    static FVector GetParkingLocation( const FActorPoolInfos & pool_infos, int slot_index );
 
 #if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+    void ReportHeldInstances( double now );
+    void DumpHeldInstancesAges( FOutputDevice & output_device, double now ) const;
     void DumpPoolInfos( FOutputDevice & output_device ) const;
 #endif
 
 private:
-    void DisableActor( AActor * actor ) const;
-    AActor * SpawnActorAndAddToInstances( UWorld * world );
+    struct Reservation
+    {
+        int Count;
+        double Deadline;
+    };
 
+    int GetRequiredCount() const;
+    void DisableActor( AActor * actor ) const;
+    // The mutations of the returned actor must happen outside of the cluster, or the garbage collector would not see them, so the callers dissolve it first
+    void DisableReturnedActor( AActor * actor, int slot_index );
+    void QueueNetDormancy( AActor * actor, ENetDormancy net_dormancy, bool force_net_update = false ) const;
+    void QueueForceNetUpdate( AActor * actor ) const;
+    // On the server, replicates the acquisition state of an instance of a pool matching the replicated instances on clients
+    void SetNetAcquired( AActor * actor, bool is_acquired ) const;
+    void ParkComponents( AActor * actor ) const;
+    void UnparkComponents( AActor * actor ) const;
+    FVector GetParkingLocation( int slot_index ) const;
+    void AdoptInstance( AActor * actor );
+    void SetSlotInstance( int slot_index, AActor * actor );
+    void RemoveSlotInstance( int slot_index );
+    int FindSlotIndex( const AActor * actor ) const;
+    void StripComponents( AActor * actor ) const;
+    void DissolveIdleInstancesCluster();
+    bool RemoveProxy( int proxy_id );
+    AActor * SpawnActorAndAddToInstances( UWorld * world, int prewarm_index = INDEX_NONE );
+    static int64 MeasureInstanceMemorySize( const AActor * actor );
+
+    // Indexed by slot. Empty slots hold nullptr
     UPROPERTY()
     TArray< AActor * > Instances;
 
-    int AvailableInstanceIndex;
+    // The slot of each instance, so an instance is found without walking Instances
+    TMap< TObjectKey< AActor >, int > SlotIndices;
+
+    UPROPERTY()
+    UAPPoolClusterRoot * IdleInstancesCluster;
+
+    // The ticks disabled while the idle instances are in the cluster, enabled again when it is dissolved
+    TArray< TWeakObjectPtr< AActor > > TickDisabledActors;
+    TArray< TWeakObjectPtr< UActorComponent > > TickDisabledComponents;
+
+    UPROPERTY()
+    UInstancedStaticMeshComponent * ProxyComponent;
+
+    // Only filled on dedicated servers
+    UPROPERTY()
+    TArray< UClass * > StrippedComponentClasses;
+
+    // The rows of the proxy component are kept contiguous, so the proxies are addressed by id through these two tables
+    TArray< int > ProxyIdByRow;
+    TMap< int, int > RowByProxyId;
+    int NextProxyId;
+
+    TMap< int, Reservation > Reservations;
+    int NextReservationId;
+    int ReservedCount;
+
+    FAPPoolSlots Slots;
+    int PoolId;
     FActorPoolInfos PoolInfos;
+    int TargetCount;
+    FAPArchetypeSnapshot ArchetypeSnapshot;
+    int64 InstanceMemorySize;
+    double LastAcquireTime;
+    double IdleInstancesChangeTime;
+    uint8 bIsDrivenByServer : 1;
+    uint8 bIsIdleInstancesClusterDirty : 1;
+    uint8 bIsResizing : 1;
+    // Set when the pool must still shrink but all its instances in excess are acquired
+    uint8 bIsShrinkPending : 1;
 };
 
+FORCEINLINE int FActorPoolInstances::GetPoolId() const
+{
+    return PoolId;
+}
+
+FORCEINLINE AActor * FActorPoolInstances::ResolveActorRef( const FAPPooledActorRef & ref ) const
+{
+    if ( !Instances.IsValidIndex( ref.SlotIndex ) )
+    {
+        return nullptr;
+    }
+
+    return Slots.GetSlot( ref.SlotIndex ).Generation == ref.Generation ? Instances[ ref.SlotIndex ] : nullptr;
+}
+
+FORCEINLINE bool FActorPoolInstances::IsResizing() const
+{
+    return bIsResizing;
+}
+
+FORCEINLINE int FActorPoolInstances::GetRequiredCount() const
+{
+    return TargetCount + ReservedCount;
+}
+
+FORCEINLINE int FActorPoolInstances::GetProxyCount() const
+{
+    return ProxyIdByRow.Num();
+}
+
+FORCEINLINE int FActorPoolInstances::GetInstanceCount() const
+{
+    return Slots.GetAvailableSlotCount() + Slots.GetAcquiredSlotCount();
+}
+
+FORCEINLINE int FActorPoolInstances::GetIdleInstanceCount() const
+{
+    return Slots.GetAvailableSlotCount();
+}
+
+FORCEINLINE int FActorPoolInstances::GetEvictableInstanceCount() const
+{
+    return FMath::Max( GetIdleInstanceCount() - ReservedCount, 0 );
+}
+
+FORCEINLINE int64 FActorPoolInstances::GetInstanceMemorySize() const
+{
+    return InstanceMemorySize;
+}
+
+FORCEINLINE int64 FActorPoolInstances::GetMemorySize() const
+{
+    return InstanceMemorySize * GetInstanceCount();
+}
+
+FORCEINLINE int FActorPoolInstances::GetPriority() const
+{
+    return PoolInfos.Priority;
+}
+
+FORCEINLINE double FActorPoolInstances::GetLastAcquireTime() const
+{
+    return LastAcquireTime;
+}
+
+FORCEINLINE bool FActorPoolInstances::IsDrivenByServer() const
+{
+    return bIsDrivenByServer;
+}
+
+FORCEINLINE const FActorPoolInfos & FActorPoolInstances::GetPoolInfos() const
+{
+    return PoolInfos;
+}
+
 UCLASS( NotPlaceable, NotBlueprintType, NotBlueprintable )
 class ACTORPOOL_API AActorPoolActor : public AActor
 {
@@ -106,25 +313,141 @@ public:
 
     void BeginPlay() override;
     void EndPlay( const EEndPlayReason::Type end_play_reason ) override;
+    void Tick( float delta_seconds ) override;
 
     bool IsActorClassPoolable( TSubclassOf< AActor > actor_class ) const;
+    int GetIdleInstanceCount( TSubclassOf< AActor > actor_class ) const;
+    int GetInstanceCount( TSubclassOf< AActor > actor_class ) const;
+    // True when the pool only mirrors the instances of the server, and can not be acquired from on this side of the network
+    bool IsPoolDrivenByServer( TSubclassOf< AActor > actor_class ) const;
 
     void RegisterPooledActor( const FActorPoolInfos & actor_pool_infos );
     void UnRegisterPooledActor( const FActorPoolInfos & actor_pool_infos );
 
-    AActor * GetActorFromPool( TSubclassOf< AActor > actor_class );
+    AActor * GetActorFromPool( TSubclassOf< AActor > actor_class, const FTransform & transform, FName caller_tag = NAME_None, const FInstancedStruct * payload = nullptr );
     void FinishAcquireActor( FActorPoolRequestHandle handle );
 
-    bool ReturnActorToPool( AActor * actor );
+    bool ReturnActorToPool( AActor * actor, FName caller_tag = NAME_None );
+    // Called on clients when the acquisition state of an instance of a pool driven by the server is replicated
+    void MirrorServerInstance( AActor * actor, bool is_acquired );
+    // Queues the actor to be returned to its pool during the next tick of this actor, unless it has been returned and acquired again meanwhile.
+    // Returns false if there is no pool for the class of the actor or if the actor is not acquired
+    bool ReturnActorToPoolDeferred( AActor * actor, FName caller_tag = NAME_None );
+
+    UObject * GetObjectFromPool( TSubclassOf< UObject > object_class, FName caller_tag = NAME_None );
+    // Registers the component, and attaches it to attach_parent if it is a scene component
+    UActorComponent * GetComponentFromPool( TSubclassOf< UActorComponent > component_class, USceneComponent * attach_parent, FName socket_name, FName caller_tag = NAME_None );
+    bool ReturnObjectToPool( UObject * object, FName caller_tag = NAME_None );
+
+    // Returns an invalid reference if the actor is not acquired from a pool
+    FAPPooledActorRef GetPooledActorRef( const AActor * actor ) const;
+    // Returns nullptr if the actor has been returned to the pool since the reference was created
+    AActor * ResolvePooledActorRef( const FAPPooledActorRef & ref ) const;
+
+    FAPPooledProxyHandle AcquireProxy( TSubclassOf< AActor > actor_class, const FTransform & transform );
+    bool ReturnProxy( const FAPPooledProxyHandle & handle );
+    // Acquires an actor at the transform of the proxy, returned in transform, and removes the proxy if it succeeds
+    AActor * HydrateProxy( const FAPPooledProxyHandle & handle, FTransform & transform, FName caller_tag = NAME_None );
+    FAPPooledProxyHandle DehydrateActor( AActor * actor, FName caller_tag = NAME_None );
+
+    // Returns an invalid handle if there is no pool for the actor class, or if the pool is driven by the server
+    FAPPoolReservationHandle ReserveCapacity( TSubclassOf< AActor > actor_class, int count, float deadline );
+    bool ReleaseReservation( const FAPPoolReservationHandle & handle );
+
+    // Removes the idle instances of the pools flagged with bPersistAcrossSeamlessTravel, so they are not destroyed with this actor
+    void HandOverSeamlessTravelInstances( TArray< AActor * > & traveling_instances );
 
 #if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
     void DestroyUnusedInstancesInPools();
+    void DumpHeldInstancesAges( FOutputDevice & output_device ) const;
     void DumpPoolInfos( FOutputDevice & output_device ) const;
 #endif
 
 private:
-    FActorPoolInstances CreateActorPoolInstance( const FActorPoolInfos & pool_infos ) const;
+    struct LevelScopedPool
+    {
+        explicit LevelScopedPool( const FActorPoolInfos & pool_infos );
+
+        bool IsForLevel( const ULevel * level ) const;
+
+        FActorPoolInfos PoolInfos;
+        FName LevelPackageName;
+        FTimerHandle DestroyTimerHandle;
+    };
+
+    struct DeferredReturn
+    {
+        FAPPooledActorRef Ref;
+        TWeakObjectPtr< AActor > Actor;
+        FName CallerTag;
+    };
+
+    void AddActorPool( const FActorPoolInfos & actor_pool_infos, bool is_prewarm_deferred = false );
+    void RemoveActorPool( const FActorPoolInfos & actor_pool_infos );
+    void AddObjectPool( const FAPObjectPoolInfos & object_pool_infos );
+    bool CanCreatePool( bool spawn_on_server, bool spawn_on_clients ) const;
+    void OnLevelAddedToWorld( ULevel * level, UWorld * world );
+    void OnLevelRemovedFromWorld( ULevel * level, UWorld * world );
+    void OnLevelScopedPoolExpired( TSoftClassPtr< AActor > actor_class );
+    // Returns true if the actor was acquired from a removed pool, in which case it is destroyed
+    bool DestroyRetiredInstance( AActor * actor );
+    int64 GetMemorySize() const;
+    void EnforceMemoryBudget();
+    FActorPoolInstances * FindActorPool( TSubclassOf< AActor > actor_class );
+    const FActorPoolInstances * FindActorPool( TSubclassOf< AActor > actor_class ) const;
+    // Returns nullptr if the pool of the id has been removed, even if its index is used by another pool
+    FActorPoolInstances * FindPoolById( int pool_id );
+    const FActorPoolInstances * FindPoolById( int pool_id ) const;
+    void UpdateIdleInstancesClusters();
+    // Only runs the cluster updates while a pool clusters its idle instances
+    void UpdateIdleInstancesClustersTimer();
+    void ProcessDeferredReturns();
+    void OnConsoleVariablesChanged();
+    void ResizePools();
+    bool IsResizingPools() const;
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+    void ReportHeldInstances();
+#endif
+
+    FActorPoolInstances & AddActorPoolInstance( TSubclassOf< AActor > actor_class, const FActorPoolInfos & pool_infos, bool is_prewarm_deferred = false );
+    void RemoveActorPoolInstance( TSubclassOf< AActor > actor_class );
+    UInstancedStaticMeshComponent * CreateProxyComponent( const FActorPoolInfos & pool_infos );
+    void DestroyUnclaimedTravelingInstances();
+    void DestroyBakedInstances( const UClass * actor_class );
+    void ClaimBakedInstances( const ULevel * level );
+
+    // A pool id holds the index of the pool in ActorPools in its low bits, and a serial in its high bits
+    static constexpr int PoolIndexBits = 16;
+    static constexpr int PoolIndexMask = ( 1 << PoolIndexBits ) - 1;
+    static constexpr int PoolSerialMask = MAX_int32 >> PoolIndexBits;
+
+    // Indexed by the pool index of the ids, so a reference resolves its pool with an array access. The removed pools are left empty until their index is reused
+    UPROPERTY()
+    TArray< FActorPoolInstances > ActorPools;
+
+    TMap< TSubclassOf< AActor >, int > ActorPoolIndices;
+    TArray< int > FreePoolIndices;
 
     UPROPERTY()
-    TMap< TSubclassOf< AActor >, FActorPoolInstances > ActorPools;
+    TMap< TSubclassOf< UObject >, FAPObjectPoolInstances > ObjectPools;
+
+    TArray< LevelScopedPool > LevelScopedPools;
+    TArray< DeferredReturn > DeferredReturns;
+
+    // The classes of the pools registered on a side of the network which does not create them. Their baked instances are destroyed
+    TSet< TSubclassOf< AActor > > SkippedPoolClasses;
+
+    // The instances which were acquired when their pool was removed. They are destroyed when they are returned
+    TSet< TWeakObjectPtr< AActor > > RetiredInstances;
+
+    int NextPoolSerial;
+
+#if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
+    FTimerHandle HeldInstancesScanTimerHandle;
+#endif
+
+    FTimerHandle IdleInstancesClustersTimerHandle;
+    FTimerHandle UnclaimedTravelingInstancesTimerHandle;
+    FConsoleVariableSinkHandle ConsoleVariableSinkHandle;
 };
@@ -8,6 +8,9 @@
 #include "ActorPoolSettings.generated.h"
 
 class AActor;
+class UActorComponent;
+class UStaticMesh;
+class UWorld;
 
 UENUM()
 enum class EAPPoolingPolicy : uint8
@@ -16,6 +19,17 @@ enum class EAPPoolingPolicy : uint8
     LoopInstances
 };
 
+UENUM()
+enum class EAPPhysicsParkingMode : uint8
+{
+    // The simulating bodies are left untouched when the actor is returned to the pool
+    None,
+    // The velocities of the simulating bodies are cleared and the bodies are put to sleep
+    Sleep,
+    // The velocities of the simulating bodies are cleared and the simulation is disabled until the actor is acquired again
+    DisableSimulation
+};
+
 USTRUCT()
 struct FAPPooledActorAcquireFromPoolSettings
 {
@@ -43,12 +57,20 @@ struct FActorPoolInfos
 
     FActorPoolInfos();
 
+    // Returns the count of the override of the active device profile or of one of its parents if any,
+    // otherwise Count multiplied by ActorPool.CountScale, which device profiles and scalability groups can set
+    int GetScaledCount() const;
+
     UPROPERTY( EditAnywhere )
     TSoftClassPtr< AActor > ActorClass;
 
     UPROPERTY( EditAnywhere )
     int Count;
 
+    // Counts used instead of Count, by device profile name. An override also applies to the device profiles which inherit from its profile
+    UPROPERTY( EditAnywhere )
+    TMap< FString, int > DeviceProfileCountOverrides;
+
     UPROPERTY( EditAnywhere )
     EAPPoolingPolicy PoolingPolicy;
 
@@ -60,6 +82,108 @@ struct FActorPoolInfos
 
     UPROPERTY( EditAnywhere )
     uint8 bSpawnOnClients : 1;
+
+    // When on, the instances prewarmed by the clients are reused for the replicated instances of the server, instead of spawning new actors on the clients.
+    // The server and the clients must prewarm the same number of instances, and the pool can only be used by the server
+    UPROPERTY( EditAnywhere, meta = ( EditCondition = "bSpawnOnServer && bSpawnOnClients" ) )
+    uint8 bMatchReplicatedInstancesOnClients : 1;
+
+    // When on, the instances never replicate, even if their class does. They are kept out of the replication and their dormancy is never changed
+    UPROPERTY( EditAnywhere, meta = ( EditCondition = "!bMatchReplicatedInstancesOnClients" ) )
+    uint8 bNeverReplicate : 1;
+
+    // When on, the properties declared by the actor class which differ from the class default object are restored in a single native pass when an instance is returned to the pool
+    UPROPERTY( EditAnywhere )
+    uint8 bResetToArchetypeOnReturn : 1;
+
+    UPROPERTY( EditAnywhere )
+    EAPPhysicsParkingMode PhysicsParkingMode;
+
+    // When on, the instances are spawned and moved back to a parking cell when they are returned to the pool
+    UPROPERTY( EditAnywhere )
+    uint8 bUseParkingLocation : 1;
+
+    UPROPERTY( EditAnywhere, meta = ( EditCondition = "bUseParkingLocation" ) )
+    FTransform ParkingTransform;
+
+    // Half size of the parking volume centered on ParkingTransform. Leave to zero to park all the instances at ParkingTransform
+    UPROPERTY( EditAnywhere, meta = ( EditCondition = "bUseParkingLocation" ) )
+    FVector ParkingExtent;
+
+    // Distance between two parking cells inside the parking volume. Use a distance larger than a broadphase cell to keep the instances apart
+    UPROPERTY( EditAnywhere, meta = ( EditCondition = "bUseParkingLocation" ) )
+    FVector ParkingSpacing;
+
+    // When on, the idle instances don't generate overlap events and don't affect the navigation
+    UPROPERTY( EditAnywhere )
+    uint8 bIsolateIdleInstances : 1;
+
+    // When on, the idle instances are grouped in a garbage collection cluster, so the garbage collector does not walk their references.
+    // Enable Can Be In Cluster in the defaults of the actor class, otherwise the instances stay out of the cluster.
+    // The actor and component ticks of the clustered instances are disabled until they leave the cluster. Their timers and latent actions keep running,
+    // so stop them in OnReturnedToPool: they must not change the references of an idle instance
+    UPROPERTY( EditAnywhere )
+    uint8 bClusterIdleInstances : 1;
+
+    // When on, the idle instances are kept during a seamless travel and adopted by the pool of the destination world, instead of being destroyed and spawned again.
+    // Your game mode and player controller must add UActorPoolSubSystem::GetSeamlessTravelActorList to their own GetSeamlessTravelActorList
+    UPROPERTY( EditAnywhere, meta = ( EditCondition = "!bMatchReplicatedInstancesOnClients" ) )
+    uint8 bPersistAcrossSeamlessTravel : 1;
+
+    // When set, the pool is only created while this level is streamed in the world
+    UPROPERTY( EditAnywhere )
+    TSoftObjectPtr< UWorld > StreamingLevel;
+
+    // Delay in seconds between the moment StreamingLevel is streamed out and the moment the pool is destroyed. The pool is kept if the level comes back in the meantime
+    UPROPERTY( EditAnywhere )
+    float StreamedOutPoolLifetime;
+
+    // When the memory budget is exceeded, the idle instances of the pools with the lowest priority are evicted first
+    UPROPERTY( EditAnywhere )
+    int Priority;
+
+    // In non shipping builds, instances acquired for longer than this duration in seconds are reported in the log. 0 disables the report
+    UPROPERTY( EditAnywhere )
+    float MaxHeldDuration;
+
+    // When set, the pool can also hand out proxies: rows of an instanced static mesh using this mesh, which can be hydrated into actors when the gameplay needs them
+    UPROPERTY( EditAnywhere )
+    TSoftObjectPtr< UStaticMesh > ProxyMesh;
+
+    // On dedicated servers, the components of these classes are destroyed as soon as an instance is created, in addition to the ones listed in the settings
+    UPROPERTY( EditAnywhere )
+    TArray< TSoftClassPtr< UActorComponent > > DedicatedServerStrippedComponentClasses;
+};
+
+// Pool of actor components or of plain objects. The instances are outered to the pool actor.
+// Components are registered and attached when acquired, detached and unregistered when returned
+USTRUCT()
+struct FAPObjectPoolInfos
+{
+    GENERATED_USTRUCT_BODY()
+
+    FAPObjectPoolInfos();
+
+    UPROPERTY( EditAnywhere )
+    TSoftClassPtr< UObject > ObjectClass;
+
+    UPROPERTY( EditAnywhere )
+    int Count;
+
+    UPROPERTY( EditAnywhere )
+    EAPPoolingPolicy PoolingPolicy;
+
+    UPROPERTY( EditAnywhere )
+    uint8 bSpawnOnServer : 1;
+
+    UPROPERTY( EditAnywhere )
+    uint8 bSpawnOnClients : 1;
+
+    UPROPERTY( EditAnywhere )
+    uint8 bResetToArchetypeOnReturn : 1;
+
+    UPROPERTY( EditAnywhere )
+    float MaxHeldDuration;
 };
 
 UCLASS( config = Game, defaultconfig, meta = ( DisplayName = "ActorPool" ) )
@@ -68,8 +192,26 @@ class ACTORPOOL_API UActorPoolSettings final : public UDeveloperSettings
     GENERATED_BODY()
 
 public:
+    UActorPoolSettings();
+
     FName GetCategoryName() const override;
 
     UPROPERTY( EditAnywhere, config )
     TArray< FActorPoolInfos > PoolInfos;
+
+    UPROPERTY( EditAnywhere, config )
+    TArray< FAPObjectPoolInfos > ObjectPoolInfos;
+
+    // Maximum amount of memory, in bytes, the instances of all the pools can use. Idle instances are evicted when it is exceeded. 0 means no budget
+    UPROPERTY( EditAnywhere, config )
+    int64 MemoryBudget;
+
+    // Tick group in which the actors returned with ReturnActorToPoolDeferred are returned to their pool
+    UPROPERTY( EditAnywhere, config )
+    TEnumAsByte< ETickingGroup > DeferredReturnTickGroup;
+
+    // On dedicated servers, the components of these classes are destroyed as soon as an instance of any pool is created.
+    // Use it for the cosmetic components, like audio, particles, decals or widgets. The root component of an actor is never destroyed
+    UPROPERTY( EditAnywhere, config )
+    TArray< TSoftClassPtr< UActorComponent > > DedicatedServerStrippedComponentClasses;
 };
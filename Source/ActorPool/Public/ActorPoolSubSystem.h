@@ -3,6 +3,7 @@
 #include "ActorPoolActor.h"
 
 #include <CoreMinimal.h>
+#include <InstancedStruct.h>
 #include <Subsystems/WorldSubsystem.h>
 
 #include "ActorPoolSubSystem.generated.h"
@@ -17,14 +18,28 @@ class ACTORPOOL_API UActorPoolSubSystem final : public UWorldSubsystem
     GENERATED_BODY()
 
 public:
+    void Initialize( FSubsystemCollectionBase & collection ) override;
+    void Deinitialize() override;
+
     UFUNCTION( BlueprintPure )
     bool IsActorPoolable( AActor * actor ) const;
 
     UFUNCTION( BlueprintPure )
     bool IsActorClassPoolable( TSubclassOf< AActor > actor_class ) const;
 
-    FActorPoolRequestHandle GetActorFromPool( TSubclassOf< AActor > actor_class, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool );
-    FActorPoolRequestHandle GetActorFromPoolWithTransform( TSubclassOf< AActor > actor_class, FTransform transform, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool );
+    UFUNCTION( BlueprintPure )
+    int GetIdleInstanceCount( TSubclassOf< AActor > actor_class ) const;
+
+    UFUNCTION( BlueprintPure )
+    int GetInstanceCount( TSubclassOf< AActor > actor_class ) const;
+
+    bool IsPoolDrivenByServer( TSubclassOf< AActor > actor_class ) const;
+
+    // caller_tag identifies the caller in the logs about leaked or double returned instances
+    FActorPoolRequestHandle GetActorFromPool( TSubclassOf< AActor > actor_class, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool, FName caller_tag = NAME_None );
+    FActorPoolRequestHandle GetActorFromPoolWithTransform( TSubclassOf< AActor > actor_class, FTransform transform, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool, FName caller_tag = NAME_None );
+    // The payload is delivered to IAPPooledActorInterface with the transform, after OnAcquiredFromPool and before the actor becomes visible and collidable
+    FActorPoolRequestHandle GetActorFromPoolWithPayload( TSubclassOf< AActor > actor_class, FTransform transform, const FInstancedStruct & payload, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool, FName caller_tag = NAME_None );
 
     UFUNCTION( BlueprintCallable, DisplayName = "GetActorFromPool" )
     FActorPoolRequestHandle K2_GetActorFromPool( TSubclassOf< AActor > actor_class, FAPOnActorGotFromPoolDynamicDelegate on_actor_got_from_pool );
@@ -32,16 +47,77 @@ public:
     UFUNCTION( BlueprintCallable, DisplayName = "GetActorFromPool - WithTransform" )
     FActorPoolRequestHandle K2_GetActorFromPoolWithTransform( TSubclassOf< AActor > actor_class, FTransform transform, FAPOnActorGotFromPoolDynamicDelegate on_actor_got_from_pool );
 
+    UFUNCTION( BlueprintCallable, DisplayName = "GetActorFromPool - WithPayload" )
+    FActorPoolRequestHandle K2_GetActorFromPoolWithPayload( TSubclassOf< AActor > actor_class, FTransform transform, const FInstancedStruct & payload, FAPOnActorGotFromPoolDynamicDelegate on_actor_got_from_pool );
+
     // Gets an actor from the pool and returns it immediately.
     // Use this function only when you are sure that the actor you acquire does not have a delayed initialization and does not call FinishAcquireActor
-    UFUNCTION( BlueprintCallable, DisplayName = "GetActorFromPool - WithTransform - NoDeferred", meta = ( DeterminesOutputType = "actor_class" ) )
-    AActor * GetActorFromPoolWithTransformNoDeferred( TSubclassOf< AActor > actor_class, FTransform transform );
+    UFUNCTION( BlueprintCallable, DisplayName = "GetActorFromPool - WithTransform - NoDeferred", meta = ( DeterminesOutputType = "actor_class", DefaultToSelf = "caller", HidePin = "caller" ) )
+    AActor * GetActorFromPoolWithTransformNoDeferred( TSubclassOf< AActor > actor_class, FTransform transform, const UObject * caller = nullptr );
 
-    UFUNCTION( BlueprintCallable )
-    bool ReturnActorToPool( AActor * actor );
+    UFUNCTION( BlueprintCallable, DisplayName = "GetActorFromPool - WithPayload - NoDeferred", meta = ( DeterminesOutputType = "actor_class", DefaultToSelf = "caller", HidePin = "caller" ) )
+    AActor * GetActorFromPoolWithPayloadNoDeferred( TSubclassOf< AActor > actor_class, FTransform transform, const FInstancedStruct & payload, const UObject * caller = nullptr );
+
+    UFUNCTION( BlueprintCallable, meta = ( DefaultToSelf = "caller", HidePin = "caller" ) )
+    bool ReturnActorToPool( AActor * actor, const UObject * caller = nullptr );
+    bool ReturnActorToPoolWithTag( AActor * actor, FName caller_tag );
+
+    // Returns the actor to its pool later in the frame, in the tick group set in the settings.
+    // Use it from overlap, hit or physics callbacks, where disabling the collision of the actor right away is not safe
+    UFUNCTION( BlueprintCallable, meta = ( DefaultToSelf = "caller", HidePin = "caller" ) )
+    bool ReturnActorToPoolDeferred( AActor * actor, const UObject * caller = nullptr );
+    bool ReturnActorToPoolDeferredWithTag( AActor * actor, FName caller_tag );
 
     UFUNCTION( BlueprintCallable )
     bool FinishAcquireActor( FActorPoolRequestHandle handle );
+    // Drops a deferred acquisition which has not been finished yet, and returns its actor to the pool. Its callback is never called
+    bool CancelAcquireActor( FActorPoolRequestHandle handle, FName caller_tag = NAME_None );
+
+    UFUNCTION( BlueprintCallable, meta = ( DeterminesOutputType = "object_class", DefaultToSelf = "caller", HidePin = "caller" ) )
+    UObject * GetObjectFromPool( TSubclassOf< UObject > object_class, const UObject * caller = nullptr );
+
+    // Registers the component, and attaches it to attach_parent if it is a scene component. While acquired, any component is owned by the actor of attach_parent
+    UFUNCTION( BlueprintCallable, meta = ( DeterminesOutputType = "component_class", DefaultToSelf = "caller", HidePin = "caller" ) )
+    UActorComponent * GetComponentFromPool( TSubclassOf< UActorComponent > component_class, USceneComponent * attach_parent, FName socket_name, const UObject * caller = nullptr );
+
+    UFUNCTION( BlueprintCallable, meta = ( DefaultToSelf = "caller", HidePin = "caller" ) )
+    bool ReturnObjectToPool( UObject * object, const UObject * caller = nullptr );
+
+    // Returns a reference to an acquired pooled actor, which stops resolving once the actor is returned to the pool.
+    // Prefer it to a raw or weak pointer when the actor can be cached longer than its acquisition
+    UFUNCTION( BlueprintPure )
+    FAPPooledActorRef GetPooledActorRef( AActor * actor ) const;
+
+    UFUNCTION( BlueprintPure )
+    AActor * ResolvePooledActorRef( const FAPPooledActorRef & ref ) const;
+
+    // Adds a proxy of the actor class at the given transform, in the instanced static mesh of its pool. The pool must have a proxy mesh
+    UFUNCTION( BlueprintCallable )
+    FAPPooledProxyHandle AcquireProxy( TSubclassOf< AActor > actor_class, FTransform transform );
+
+    UFUNCTION( BlueprintCallable )
+    bool ReturnProxy( FAPPooledProxyHandle handle );
+
+    // Replaces the proxy by an actor acquired from the pool at the transform of the proxy, going through the deferred acquisition of the actor like GetActorFromPool.
+    // The proxy is kept if no actor can be acquired
+    FActorPoolRequestHandle HydrateProxy( FAPPooledProxyHandle handle, FAPOnActorGotFromPoolDelegate on_actor_got_from_pool, FName caller_tag = NAME_None );
+
+    UFUNCTION( BlueprintCallable, DisplayName = "HydrateProxy" )
+    FActorPoolRequestHandle K2_HydrateProxy( FAPPooledProxyHandle handle, FAPOnActorGotFromPoolDynamicDelegate on_actor_got_from_pool );
+
+    // Returns the actor to its pool and replaces it by a proxy at its transform
+    UFUNCTION( BlueprintCallable, meta = ( DefaultToSelf = "caller", HidePin = "caller" ) )
+    FAPPooledProxyHandle DehydrateActor( AActor * actor, const UObject * caller = nullptr );
+
+    // Grows the pool of the actor class by count instances, spread over the frames, and all at once when the deadline, in seconds from now, is reached.
+    // While the pool is below its count plus its reservations, a pool using LoopInstances creates new instances instead of recycling the acquired ones.
+    // The reserved idle instances are not evicted by the memory budget
+    UFUNCTION( BlueprintCallable )
+    FAPPoolReservationHandle ReserveCapacity( TSubclassOf< AActor > actor_class, int count, float deadline );
+
+    // The reserved instances which are idle are destroyed over the frames
+    UFUNCTION( BlueprintCallable )
+    bool ReleaseReservation( FAPPoolReservationHandle handle );
 
     void RegisterActorPoolActor( AActorPoolActor * actor_pool_actor );
     bool IsActorPoolReady() const;
@@ -49,8 +125,21 @@ public:
     void RegisterPooledActor( const FActorPoolInfos & actor_pool_infos );
     void UnRegisterPooledActor( const FActorPoolInfos & actor_pool_infos );
 
+    // Call it from the GetSeamlessTravelActorList of your game mode and of your player controller, so the pools flagged with bPersistAcrossSeamlessTravel keep their idle instances
+    void GetSeamlessTravelActorList( TArray< AActor * > & actor_list );
+
+    // Dormancy changes of the pooled actors are applied once per frame, right before the replication, so an actor acquired and returned in the same frame does not touch its channel
+    void QueueNetDormancy( AActor * actor, ENetDormancy net_dormancy, bool force_net_update = false );
+    // Forces a net update of the actor with the next flush, without changing the dormancy queued for it
+    void QueueForceNetUpdate( AActor * actor );
+    // Called on clients by UAPPooledActorNetComponent when the server acquired or returned the instance
+    void MirrorServerInstance( AActor * actor, bool is_acquired );
+    // Called by the pools which recycle an acquired instance, so the deferred acquisition of its previous owner is never finished
+    void DropAcquireRequests( const AActor * actor );
+
 #if !( UE_BUILD_SHIPPING || UE_BUILD_TEST )
     void DestroyUnusedInstancesInPools();
+    void DumpHeldInstancesAges( FOutputDevice & output_device ) const;
     void DumpPoolInfos( FOutputDevice & output_device ) const;
 #endif
 
@@ -70,13 +159,33 @@ private:
         FActorPoolRequestHandle Handle;
     };
 
+    struct PendingNetDormancy
+    {
+        PendingNetDormancy() :
+            NetDormancy( DORM_Awake ),
+            bHasNetDormancy( false ),
+            bForceNetUpdate( false )
+        {}
+
+        ENetDormancy NetDormancy;
+        bool bHasNetDormancy;
+        bool bForceNetUpdate;
+    };
+
     void BroadcastOnActorPoolReadyEvent();
+    // Gives the actor to the callback, or starts its deferred acquisition if it uses one
+    FActorPoolRequestHandle HandOverAcquiredActor( AActor * actor, const FTransform & transform, const FAPOnActorGotFromPoolDelegate & on_actor_got_from_pool );
+    void OnWorldPostActorTick( UWorld * world, ELevelTick tick_type, float delta_seconds );
+    void FlushPendingNetDormancies();
+    bool CanQueueNetDormancy( const AActor * actor ) const;
 
     UPROPERTY()
     AActorPoolActor * ActorPoolActor;
 
     TArray< FAPOnActorPoolReadyEvent > OnActorPoolReadyEvents;
     TArray< PendingActorRequest > PendingActorRequests;
+    TMap< TWeakObjectPtr< AActor >, PendingNetDormancy > PendingNetDormancies;
+    FDelegateHandle OnWorldPostActorTickHandle;
 };
 
 FORCEINLINE bool UActorPoolSubSystem::IsActorPoolReady() const